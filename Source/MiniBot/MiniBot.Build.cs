@@ -14,7 +14,8 @@ public class MiniBot : ModuleRules
 			"CoreUObject", 
 			"Engine", 
 			"InputCore",
-			"EnhancedInput"
+			"EnhancedInput",
+			"AIModule"
 		});
 
 		// Uncomment if you are using Slate UI
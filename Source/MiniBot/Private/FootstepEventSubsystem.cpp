@@ -0,0 +1,34 @@
+#include "FootstepEventSubsystem.h"
+
+void UFootstepEventSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	PendingEvents.Reserve(InitialEventCapacity);
+	FrameEvents.Reserve(InitialEventCapacity);
+}
+
+void UFootstepEventSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Everything queued this frame becomes the batch, last frame's array is reused for the next frame's events
+	Swap(PendingEvents, FrameEvents);
+	PendingEvents.Reset();
+
+	if (FrameEvents.Num() > 0)
+	{
+		OnFootstepBatch.Broadcast(FrameEvents);
+	}
+}
+
+TStatId UFootstepEventSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UFootstepEventSubsystem, STATGROUP_Tickables);
+}
+
+void UFootstepEventSubsystem::EnqueueEvent(const FFootstepEvent& Event)
+{
+	check(IsInGameThread());
+	PendingEvents.Add(Event);
+}
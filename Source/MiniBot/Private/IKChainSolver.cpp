@@ -0,0 +1,156 @@
+#include "IKChainSolver.h"
+
+namespace
+{
+	// Same passes as the generic solver, but on stack storage with compile time bounds so the loops unroll
+	template<typename T, int32 BoneCount>
+	FIKChainSolveResult SolveFixed(TArray<UE::Math::TVector<T>>& Positions, const TArray<float>& BoneLengths, const TIKChainSolveParams<T>& Params)
+	{
+		static_assert(BoneCount >= 1, "A chain needs at least one bone");
+		constexpr int32 JointCount = BoneCount + 1;
+		check(Positions.Num() == JointCount && BoneLengths.Num() == JointCount);
+
+		UE::Math::TVector<T> Joints[JointCount];
+		T Lengths[JointCount];
+		for(int32 j = 0; j < JointCount; j++)
+		{
+			Joints[j] = Positions[j];
+			Lengths[j] = BoneLengths[j];
+		}
+
+		FIKChainSolveResult Result;
+		Joints[0] = Params.RootLocation;
+
+		for(int32 i = 0; i < Params.Iterations; i++)
+		{
+			Result.Iterations = i + 1;
+
+			// Backwards
+			Joints[JointCount - 1] = Params.TargetLocation;
+			for(int32 j = JointCount - 2; j > 0; j--)
+			{
+				Joints[j] = Joints[j + 1] + (Joints[j] - Joints[j + 1]).GetSafeNormal() * Lengths[j];
+			}
+
+			// Move Towards the Pole, 1% of the distance for every joint between the root and the end effector
+			if(Params.bUsePole)
+			{
+				for(int32 j = 1; j < JointCount - 1; j++)
+				{
+					Joints[j] += (Params.PoleLocation - Joints[j]) * T(0.01);
+				}
+			}
+
+			// Forwards
+			for(int32 j = 1; j < JointCount; j++)
+			{
+				Joints[j] = Joints[j - 1] + (Joints[j] - Joints[j - 1]).GetSafeNormal() * Lengths[j];
+			}
+
+			// Close enough ?
+			if(UE::Math::TVector<T>::Distance(Joints[JointCount - 1], Params.TargetLocation) < Params.Tolerance)
+			{
+				Result.bConverged = true;
+				break;
+			}
+		}
+
+		for(int32 j = 0; j < JointCount; j++)
+		{
+			Positions[j] = Joints[j];
+		}
+		return Result;
+	}
+}
+
+template<typename T>
+typename TIKChainSolver<T>::FSolveFunction TIKChainSolver<T>::GetSolveFunction(int32 BoneCount)
+{
+	switch(BoneCount)
+	{
+	case 2: return &SolveFixed<T, 2>;
+	case 3: return &SolveFixed<T, 3>;
+	case 4: return &SolveFixed<T, 4>;
+	default: return &TIKChainSolver<T>::SolveGeneric;
+	}
+}
+
+template<typename T>
+FIKChainSolveResult TIKChainSolver<T>::Solve(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths, const FParams& Params)
+{
+	return GetSolveFunction(Positions.Num() - 1)(Positions, BoneLengths, Params);
+}
+
+template<typename T>
+FIKChainSolveResult TIKChainSolver<T>::SolveGeneric(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths, const FParams& Params)
+{
+	FIKChainSolveResult Result;
+
+	// Update Root Position
+	Positions[0] = Params.RootLocation;
+
+	// Loop Through all the bones and solve the IK
+	for(int32 i = 0; i < Params.Iterations; i++)
+	{
+		Result.Iterations = i + 1;
+
+		// Backwards
+		BackwardsSolve(Positions, BoneLengths, Params.TargetLocation);
+
+		// Move Towards the Pole
+		if(Params.bUsePole)
+			MoveTowardsPole(Positions, Params.PoleLocation);
+
+		// Forwards
+		ForwardsSolve(Positions, BoneLengths);
+
+		// Close enough ?
+		if(FVectorType::Distance(Positions.Last(), Params.TargetLocation) < Params.Tolerance)
+		{
+			Result.bConverged = true;
+			break;
+		}
+	}
+
+	return Result;
+}
+
+template<typename T>
+void TIKChainSolver<T>::ForwardsSolve(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths)
+{
+	for(int32 j = 1; j < Positions.Num(); j++)
+	{
+		Positions[j] = Positions[j - 1] + (Positions[j] - Positions[j - 1]).GetSafeNormal() * T(BoneLengths[j]);
+	}
+}
+
+template<typename T>
+void TIKChainSolver<T>::BackwardsSolve(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths, const FVectorType& TargetLocation)
+{
+	// Set the end effector to the target location
+	Positions.Last() = TargetLocation;
+
+	for(int32 j = Positions.Num() - 2; j > 0; j--)
+	{
+		Positions[j] = Positions[j + 1] + (Positions[j] - Positions[j + 1]).GetSafeNormal() * T(BoneLengths[j]);
+	}
+}
+
+template<typename T>
+void TIKChainSolver<T>::MoveTowardsPole(TArray<FVectorType>& Positions, const FVectorType& PoleLocation)
+{
+	for (int32 i = 1; i < Positions.Num() - 1; i++) // Skip the first and last bones
+	{
+		const FVectorType CurrentJointPosition = Positions[i];
+		const FVectorType TowardsPole = PoleLocation - CurrentJointPosition;
+
+		const T MoveDistanceFraction = 0.01f; // 0.01 = 1% of the distance to the pole
+		const FVectorType MoveDirection = TowardsPole.GetSafeNormal();
+
+		// Update the bone's position
+		Positions[i] = CurrentJointPosition + MoveDirection * TowardsPole.Size() * MoveDistanceFraction;
+	}
+}
+
+template class TIKChainSolver<double>;
+template class TIKChainSolver<float>;
@@ -1,6 +1,9 @@
 ﻿#include "IKLegComponent.h"
+#include "IKLegGait.h"
+#include "IKSolverSubsystem.h"
 #include "Components/SphereComponent.h"
 #include "Kismet/KismetSystemLibrary.h"
+#include "PhysicalMaterials/PhysicalMaterial.h"
 
 UIKLegComponent::UIKLegComponent()
 {
@@ -13,6 +16,91 @@ void UIKLegComponent::BeginPlay()
 
 	// Set the start offset for the step target relative to the leg root
 	StepTargetStartOffset = StepTarget->GetComponentLocation() - GetComponentTransform().GetLocation();
+
+	// The constructor initialized the bones before the profile and overrides were loaded
+	Initialize(StepTarget, Pole, OtherLegs);
+
+	// Follow edits to the profile, see OnProfileChanged
+	if(Profile)
+	{
+		ProfileChangedHandle = Profile->OnProfileChanged.AddUObject(this, &UIKLegComponent::OnProfileChanged);
+	}
+
+	FootstepEvents = GetWorld()->GetSubsystem<UFootstepEventSubsystem>();
+	PlantedFootstep.Leg = this;
+	PlantedFootstep.Bot = GetOwner();
+	PendingFootstep = PlantedFootstep;
+	PlantOnGround();
+
+	// Register with the IK worker, stays null and solves on the game thread if the worker isn't available
+	if(bSolveIKAsync)
+	{
+		if(UIKSolverSubsystem* SolverSubsystem = GetWorld()->GetSubsystem<UIKSolverSubsystem>())
+		{
+			SolvePipeline = SolverSubsystem->RegisterLeg();
+		}
+	}
+}
+
+void UIKLegComponent::PostLoad()
+{
+	Super::PostLoad();
+
+#if WITH_EDITORONLY_DATA
+	// Move values saved before the override list into it. Without a profile every value that differs from the
+	// defaults was in use, with one only the flagged values were
+	auto MigrateSetting = [this](EIKLegSetting Setting, bool bOverride, float Value)
+	{
+		const bool bInUse = Profile ? bOverride : Value != FIKLegSettings().GetValue(Setting);
+		if (bInUse && !HasOverride(Setting))
+		{
+			SetOverride(Setting, Value);
+		}
+	};
+	MigrateSetting(EIKLegSetting::BoneCount, bOverride_BoneCount, BoneCount);
+	MigrateSetting(EIKLegSetting::BoneLength, bOverride_BoneLength, BoneLength);
+	MigrateSetting(EIKLegSetting::Iterations, bOverride_Iterations, Iterations);
+	MigrateSetting(EIKLegSetting::Tolerance, bOverride_Tolerance, Tolerance);
+	MigrateSetting(EIKLegSetting::StepDistance, bOverride_StepDistance, StepDistance);
+	MigrateSetting(EIKLegSetting::StepHeight, bOverride_StepHeight, StepHeight);
+	MigrateSetting(EIKLegSetting::StepEaseCurveExponent, bOverride_StepEaseCurveExponent, StepEaseCurveExponent);
+	MigrateSetting(EIKLegSetting::EndEffectorMaxSpeed, bOverride_EndEffectorMaxSpeed, EndEffectorMaxSpeed);
+	MigrateSetting(EIKLegSetting::MaxStepHeighPercentage, bOverride_MaxStepHeighPercentage, MaxStepHeighPercentage);
+
+	// Back to the defaults so they aren't saved again
+	const FIKLegSettings Defaults;
+	bOverride_BoneCount = bOverride_BoneLength = bOverride_Iterations = bOverride_Tolerance = bOverride_StepDistance = false;
+	bOverride_StepHeight = bOverride_StepEaseCurveExponent = bOverride_EndEffectorMaxSpeed = bOverride_MaxStepHeighPercentage = false;
+	BoneCount = Defaults.BoneCount;
+	BoneLength = Defaults.BoneLength;
+	Iterations = Defaults.Iterations;
+	Tolerance = Defaults.Tolerance;
+	StepDistance = Defaults.StepDistance;
+	StepHeight = Defaults.StepHeight;
+	StepEaseCurveExponent = Defaults.StepEaseCurveExponent;
+	EndEffectorMaxSpeed = Defaults.EndEffectorMaxSpeed;
+	MaxStepHeighPercentage = Defaults.MaxStepHeighPercentage;
+#endif
+}
+
+void UIKLegComponent::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if(Profile)
+	{
+		Profile->OnProfileChanged.Remove(ProfileChangedHandle);
+	}
+	ProfileChangedHandle.Reset();
+
+	if(SolvePipeline)
+	{
+		if(UIKSolverSubsystem* SolverSubsystem = GetWorld()->GetSubsystem<UIKSolverSubsystem>())
+		{
+			SolverSubsystem->UnregisterLeg(SolvePipeline);
+		}
+		SolvePipeline.Reset();
+	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 void UIKLegComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction)
@@ -31,8 +119,16 @@ void UIKLegComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActor
 		MoveStepTarget(DeltaTime);
 	}
 
-	// Solve the IK
-	SolveIK();
+	// Solve the IK, either right away or by handing it to the worker and applying last frame's result
+	if(SolvePipeline)
+	{
+		ConsumeSolveResult();
+		PublishSolveSnapshot();
+	}
+	else
+	{
+		SolveIK();
+	}
 
 	// Draw Debug
 	DrawDebug();
@@ -40,59 +136,149 @@ void UIKLegComponent::TickComponent(float DeltaTime, ELevelTick TickType, FActor
 
 void UIKLegComponent::Initialize(USphereComponent* InStepTarget, USphereComponent* InPole, TArray<TObjectPtr<UIKLegComponent>> InOtherLegs)
 {
-	// Reset 
-	Bones.Empty();
-	TotalLength = 0.0f;
+	// Reset, keeping the allocation so re-initializing doesn't reallocate
+	const int32 EffectiveBoneCount = GetBoneCount();
+	Bones.Reset(EffectiveBoneCount + 1);
 	
-	for (int32 i = 0; i < BoneCount + 1 ; i++) // +1 for the root bone
+	for (int32 i = 0; i < EffectiveBoneCount + 1 ; i++) // +1 for the root bone
 	{
 		FBone Bone;
-		Bone.BoneLength = (i == 0) ? 0 : BoneLength; // Root bone has no length
 		Bone.Transform = GetComponentTransform();
 		Bones.Add(Bone);
-		TotalLength += Bone.BoneLength;
+	}
+
+	// Legs using the profile's bone layout share its bone lengths and total length instead of keeping their own
+	if (UsesProfileBones())
+	{
+		BoneLengths.Empty();
+		TotalLength = 0.0f;
+	}
+	else
+	{
+		const float EffectiveBoneLength = GetBoneLength();
+		BoneLengths.Reset(Bones.Num());
+		TotalLength = 0.0f;
+		for (int32 i = 0; i < Bones.Num(); i++)
+		{
+			BoneLengths.Add((i == 0) ? 0.0f : EffectiveBoneLength); // Root bone has no length
+			TotalLength += BoneLengths[i];
+		}
 	}
 
 	// Initialize other properties
+	SolveFunction = FIKChainSolver::GetSolveFunction(EffectiveBoneCount);
+	LocalSolveFunction = FIKChainSolver3f::GetSolveFunction(EffectiveBoneCount);
 	BonePositions.SetNum(Bones.Num());
-	BoneRotations.SetNum(Bones.Num());
+	LocalBonePositions.SetNum(Bones.Num());
 	Pole = InPole;
 	StepTarget = InStepTarget;
 	OtherLegs = InOtherLegs;
 }
 
-void UIKLegComponent::SolveIK()
+const FIKLegSettings& UIKLegComponent::GetBaseSettings() const
 {
-	// Get all Bones Positions
+	static const FIKLegSettings DefaultSettings;
+	return Profile ? Profile->Settings : DefaultSettings;
+}
+
+void UIKLegComponent::SetOverride(EIKLegSetting Setting, float Value)
+{
+	FIKLegSettingOverride* Override = Overrides.FindByPredicate([Setting](const FIKLegSettingOverride& Existing) { return Existing.Setting == Setting; });
+	if (!Override)
+	{
+		Override = &Overrides.AddDefaulted_GetRef();
+		Override->Setting = Setting;
+	}
+	Override->Value = Value;
+}
+
+void UIKLegComponent::ClearOverride(EIKLegSetting Setting)
+{
+	Overrides.RemoveAll([Setting](const FIKLegSettingOverride& Override) { return Override.Setting == Setting; });
+}
+
+void UIKLegComponent::OnProfileChanged(const UIKLegProfile* ChangedProfile)
+{
+	// Not initialized yet, Initialize will pick up the new layout
+	if(!StepTarget) return;
+
+	// Bone count and length are baked into Bones, the solve functions and the cached lengths, so rebuild them all.
+	// Async results in flight were solved with the old layout
+	Initialize(StepTarget, Pole, OtherLegs);
+	SolveGeneration++;
+}
+
+void UIKLegComponent::ResetLegState()
+{
+	// Collapse all bones onto the root without touching the array allocations
+	const FTransform RootTransform = GetComponentTransform();
 	for(int32 i = 0; i < Bones.Num(); i++)
 	{
-		BonePositions[i] = Bones[i].Transform.GetLocation();
+		Bones[i].Transform = RootTransform;
+		BonePositions[i] = RootTransform.GetLocation();
 	}
-	
-	// Update Root Position
-	BonePositions[0] = GetComponentTransform().GetLocation();
-	
-	// Loop Through all the bones and solve the IK
-	for(int32 i = 0; i < Iterations; i++)
+
+	// Restore the step target to its start offset
+	if(StepTarget)
 	{
-		// Backwards
-		BackwardsSolve();
-	
-		// Move Towards the Pole
-		if(Pole)
-			MoveTowardsPole();
-		
-		// Forwards
-		ForwardsSolve();
-		
-		// Close enough ?
-		if(FVector::Distance(BonePositions.Last(), EndEffectorTargetLocation) < Tolerance)
+		StepTarget->SetRelativeLocation(StepTargetStartOffset);
+	}
+
+	// Any async result still in flight was solved for the old pose
+	SolveGeneration++;
+
+	// Drop the previous life's foothold and surface
+	PlantOnGround();
+}
+
+void UIKLegComponent::PlantOnGround()
+{
+	if(!StepTarget || !GetWorld()) return;
+
+	// Put the foot straight on the ground under the step target, with the surface it found
+	TraceStepTarget();
+	EndEffectorTargetLocation = TargetStepLocation;
+	StartStepLocation = TargetStepLocation;
+	PlantedFootstep = PendingFootstep;
+
+	// Force a zero length step so the foot lands on the next tick, which emits the Plant but no LiftOff
+	bIsPlanningFoothold = false;
+	CurrentInterpolationTime = 0.0f;
+	bIsMovingStepTarget = true;
+	bSkipLiftOff = true;
+}
+
+void UIKLegComponent::SolveIK()
+{
+	FIKChainSolveResult Result;
+	if(bSolveInRootSpace)
+	{
+		// Solve relative to the root in floats, converting only at the boundaries
+		const FTransform& RootTransform = GetComponentTransform();
+		GatherLocalBonePositions(RootTransform, LocalBonePositions);
+		Result = LocalSolveFunction(LocalBonePositions, GetSolveBoneLengths(), MakeLocalSolveParams(RootTransform));
+		SetBonePositionsFromLocal(RootTransform, LocalBonePositions);
+	}
+	else
+	{
+		// Get all Bones Positions
+		for(int32 i = 0; i < Bones.Num(); i++)
 		{
-			GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Iterations: %d"), i));
-			break;
+			BonePositions[i] = Bones[i].Transform.GetLocation();
 		}
+		Result = SolveFunction(BonePositions, GetSolveBoneLengths(), MakeSolveParams());
+	}
+
+	if(Result.bConverged)
+	{
+		GEngine->AddOnScreenDebugMessage(-1, 5.f, FColor::Red, FString::Printf(TEXT("Iterations: %d"), Result.Iterations));
 	}
 	
+	ApplyBonePositions();
+}
+
+void UIKLegComponent::ApplyBonePositions()
+{
 	// Set all the bone positions
 	for(int32 i = 0; i < Bones.Num(); i++)
 	{
@@ -108,48 +294,74 @@ void UIKLegComponent::SolveIK()
 	Bones.Last().Transform.SetLocation(EndEffectorTargetLocation);
 }
 
-void UIKLegComponent::ForwardsSolve()
+FIKChainSolveParams UIKLegComponent::MakeSolveParams() const
 {
-	for(int32 j = 1; j < Bones.Num(); j++)
+	FIKChainSolveParams Params;
+	Params.RootLocation = GetComponentTransform().GetLocation();
+	Params.TargetLocation = EndEffectorTargetLocation;
+	Params.bUsePole = Pole != nullptr;
+	Params.PoleLocation = Pole ? Pole->GetComponentLocation() : FVector::ZeroVector;
+	Params.Iterations = GetIterations();
+	Params.Tolerance = GetTolerance();
+	return Params;
+}
+
+FIKChainSolveParams3f UIKLegComponent::MakeLocalSolveParams(const FTransform& RootTransform) const
+{
+	// The root is the origin, ignore scale so bone lengths stay in world units
+	FIKChainSolveParams3f Params;
+	Params.RootLocation = FVector3f::ZeroVector;
+	Params.TargetLocation = FVector3f(RootTransform.InverseTransformPositionNoScale(EndEffectorTargetLocation));
+	Params.bUsePole = Pole != nullptr;
+	Params.PoleLocation = Pole ? FVector3f(RootTransform.InverseTransformPositionNoScale(Pole->GetComponentLocation())) : FVector3f::ZeroVector;
+	Params.Iterations = GetIterations();
+	Params.Tolerance = GetTolerance();
+	return Params;
+}
+
+void UIKLegComponent::GatherLocalBonePositions(const FTransform& RootTransform, TArray<FVector3f>& OutPositions) const
+{
+	OutPositions.SetNum(Bones.Num(), false);
+	for(int32 i = 0; i < Bones.Num(); i++)
 	{
-		BonePositions[j] = BonePositions[j - 1] + (BonePositions[j] - BonePositions[j - 1]).GetSafeNormal() * Bones[j].BoneLength;
+		OutPositions[i] = FVector3f(RootTransform.InverseTransformPositionNoScale(Bones[i].Transform.GetLocation()));
 	}
 }
 
-void UIKLegComponent::BackwardsSolve()
+void UIKLegComponent::SetBonePositionsFromLocal(const FTransform& RootTransform, const TArray<FVector3f>& InPositions)
 {
-	for(int32 j = Bones.Num() - 1; j > 0; j--)
+	const FTransform RootTransformNoScale(RootTransform.GetRotation(), RootTransform.GetLocation());
+	for(int32 i = 0; i < Bones.Num(); i++)
 	{
-		// If this is the end effector
-		if(j == Bones.Num() - 1)
-		{
-			// Set the end effector to the target location
-			BonePositions[j] = EndEffectorTargetLocation;
-		}
-		else
-		{
-			BonePositions[j] = BonePositions[j + 1] + (BonePositions[j] - BonePositions[j + 1]).GetSafeNormal() * Bones[j].BoneLength;
-		}
+		BonePositions[i] = RootTransformNoScale.TransformPosition(FVector(InPositions[i]));
 	}
 }
 
-void UIKLegComponent::MoveTowardsPole()
+void UIKLegComponent::PublishSolveSnapshot()
 {
-	if (!Pole) return;
+	// Fill the write buffer in place, it keeps its allocations between swaps
+	FIKLegSolveInput& Input = SolvePipeline->Input.GetWriteBuffer();
+	Input.RootTransform = GetComponentTransform();
+	GatherLocalBonePositions(Input.RootTransform, Input.Positions);
+	Input.BoneLengths = GetSolveBoneLengths();
+	Input.Params = MakeLocalSolveParams(Input.RootTransform);
+	Input.SolveFunction = LocalSolveFunction;
+	Input.Generation = SolveGeneration;
+	SolvePipeline->Input.SwapWriteBuffers();
+}
 
-	const FVector PolePosition = Pole->GetComponentLocation();
-	for (int32 i = 1; i < Bones.Num() - 1; i++) // Skip the first and last bones
-	{
-		FVector CurrentJointPosition = BonePositions[i];
-		FVector TowardsPole = PolePosition - CurrentJointPosition;
-		
-		const float MoveDistanceFraction = 0.01f; // 0.01 = 1% of the distance to the pole
-		FVector MoveDirection = TowardsPole.GetSafeNormal();
-		const FVector NewPosition = CurrentJointPosition + MoveDirection * TowardsPole.Size() * MoveDistanceFraction;
-	
-		// Update the bone's position
-		BonePositions[i] = NewPosition;
-	}
+void UIKLegComponent::ConsumeSolveResult()
+{
+	// Keep the current pose until the worker has published something new
+	if(!SolvePipeline->Output.IsDirty()) return;
+
+	// Skip results from before the last reset, e.g. a pose solved before the bot went back to the pool
+	const FIKLegSolveOutput& Output = SolvePipeline->Output.SwapAndRead();
+	if(Output.Generation != SolveGeneration || Output.Positions.Num() != Bones.Num()) return;
+
+	// Convert back with the root the snapshot was taken at, so planted feet don't slide with the body
+	SetBonePositionsFromLocal(Output.RootTransform, Output.Positions);
+	ApplyBonePositions();
 }
 
 void UIKLegComponent::SetStepDirection(const FVector& InDirection) const
@@ -160,7 +372,7 @@ void UIKLegComponent::SetStepDirection(const FVector& InDirection) const
 
 	Direction = GetComponentTransform().InverseTransformVectorNoScale(Direction);
 
-	StepTarget->SetRelativeLocation(StepTargetStartOffset + Direction * StepDistance);
+	StepTarget->SetRelativeLocation(FIKLegGait::GetStepTargetOffset(StepTargetStartOffset, Direction, GetStepDistance()));
 }
 
 void UIKLegComponent::DrawDebug()
@@ -187,10 +399,11 @@ void UIKLegComponent::DrawDebug()
 	if(bDrawBones)
 	{
 		// Draw the bones
+		const TArray<float>& SolveBoneLengths = GetSolveBoneLengths();
 		for(int32 i = 0; i < Bones.Num(); i++)
 		{
 			FVector Start = Bones[i].Transform.GetLocation();
-			FVector End = Start + (Bones[i].Transform.GetRotation().GetForwardVector() * Bones[i].BoneLength);
+			FVector End = Start + (Bones[i].Transform.GetRotation().GetForwardVector() * SolveBoneLengths[i]);
 			FColor Color;
 			if(i == 0)
 			{
@@ -218,7 +431,7 @@ void UIKLegComponent::DrawDebug()
 
 	// Draw step distance around the step target
 	if(bDrawStepDistance)
-		UKismetSystemLibrary::DrawDebugCircle(GetWorld(), StepTarget->GetComponentLocation(), StepDistance, 12, FColor::White,  0.0f, 1.0f, FVector(0, 1, 0), FVector(1, 0, 0), false);
+		UKismetSystemLibrary::DrawDebugCircle(GetWorld(), StepTarget->GetComponentLocation(), GetStepDistance(), 12, FColor::White,  0.0f, 1.0f, FVector(0, 1, 0), FVector(1, 0, 0), false);
 }
 
 void UIKLegComponent::MoveStepTarget(float DeltaTime)
@@ -227,74 +440,189 @@ void UIKLegComponent::MoveStepTarget(float DeltaTime)
 
 	if (CurrentInterpolationTime == 0.0f) // Check if interpolation needs to be started or if it's already started
 	{
-		// Line Trace down to find the ground
-		FHitResult HitResult;
-		const FVector StartLocation = StepTarget->GetComponentLocation() + FVector::UpVector * TotalLength * MaxStepHeighPercentage;
-		const FVector EndLocation = StepTarget->GetComponentLocation() + FVector::DownVector * TotalLength * MaxStepHeighPercentage;
-		if(UKismetSystemLibrary::LineTraceSingle(GetWorld(), StartLocation, EndLocation, ETraceTypeQuery::TraceTypeQuery1, false, TArray<AActor*>({GetOwner()}), EDrawDebugTrace::None, HitResult, true))
+		if (bPredictFootholds)
 		{
-			TargetStepLocation = HitResult.Location;
+			// Send out the candidate traces and hold the step (and the other legs) until they come back
+			if (!bIsPlanningFoothold)
+			{
+				RequestFootholdCandidates();
+				bIsPlanningFoothold = true;
+				bIsMovingStepTarget = true;
+				return;
+			}
+
+			// Results aren't in yet
+			if (!SelectFoothold()) return;
+			bIsPlanningFoothold = false;
+		}
+		else
+		{
+			TraceStepTarget();
 		}
-		else // If no ground is found, stretch it downwards TODO: This should be handled differently
+
+		// The foot leaves the surface it was planted on, unless this is the step that first puts it down
+		if (bSkipLiftOff)
 		{
-			TargetStepLocation = EndLocation;
+			bSkipLiftOff = false;
 		}
+		else
+		{
+			FFootstepEvent LiftOff = PlantedFootstep;
+			LiftOff.Type = EFootstepEventType::LiftOff;
+			LiftOff.Location = EndEffectorTargetLocation;
+			EmitFootstep(LiftOff);
+		}
+
 		StartStepLocation = EndEffectorTargetLocation; // Set the start location for interpolation
 		bIsMovingStepTarget = true; 
 	}
 	
 	CurrentInterpolationTime += DeltaTime;
 
-	const float Alpha = FMath::Clamp(CurrentInterpolationTime / InterpolationDuration, 0.0f, 1.0f);
+	const float Alpha = FMath::Clamp(CurrentInterpolationTime / GetInterpolationDuration(), 0.0f, 1.0f);
 
-	// Lerp between the start and target locations using the eased alpha
-	const float EasedHorizontalAlpha = FMath::InterpEaseInOut(0.0f, 1.0f, Alpha, StepEaseCurveExponent); 
-	FVector HorizontalLocation = FMath::Lerp(StartStepLocation, TargetStepLocation, EasedHorizontalAlpha);
+	// Eased horizontal alpha and a sine wave for the vertical offset, sampled from the profile if it's shared
+	float EasedHorizontalAlpha;
+	float VerticalOffset;
+	if (UsesProfileStepCurve())
+	{
+		Profile->EvaluateStepCurve(Alpha, EasedHorizontalAlpha, VerticalOffset);
+	}
+	else
+	{
+		FIKLegGait::EvaluateStepCurve(Alpha, GetStepEaseCurveExponent(), GetStepHeight(), EasedHorizontalAlpha, VerticalOffset);
+	}
 
-	// Calculate the vertical offset using a sine wave
-	float VerticalOffset = FMath::Sin(Alpha * PI) * StepHeight;
-	FVector FinalLocation = HorizontalLocation + FVector(0, 0, VerticalOffset);
-	
 	// Update the end effector target location with the new position, including the vertical offset
-	EndEffectorTargetLocation = FinalLocation;
+	EndEffectorTargetLocation = FIKLegGait::GetStepLocation(StartStepLocation, TargetStepLocation, EasedHorizontalAlpha, VerticalOffset);
 	
 	// Reset interpolation time if the target is reached or exceeded
 	if (Alpha >= 1.0f)
 	{
 		CurrentInterpolationTime = 0.0f; 
 		bIsMovingStepTarget = false; 
+
+		// The foot has landed
+		PlantedFootstep = PendingFootstep;
+		EmitFootstep(PlantedFootstep);
 	}
 }
 
-bool UIKLegComponent::ShouldMoveStepTarget()
+void UIKLegComponent::TraceStepTarget()
 {
-	// Check that no other legs are currently moving the step target
-	for (const TObjectPtr<UIKLegComponent> OtherLeg : OtherLegs)
+	// Line Trace down to find the ground
+	FHitResult HitResult;
+	const FVector StartLocation = StepTarget->GetComponentLocation() + FVector::UpVector * GetTotalLength() * GetMaxStepHeighPercentage();
+	const FVector EndLocation = StepTarget->GetComponentLocation() + FVector::DownVector * GetTotalLength() * GetMaxStepHeighPercentage();
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(IKLegStepTrace), false, GetOwner());
+	QueryParams.bReturnPhysicalMaterial = true;
+	if(GetWorld()->LineTraceSingleByChannel(HitResult, StartLocation, EndLocation, ECC_Visibility, QueryParams))
 	{
-		if(OtherLeg->IsMovingStepTarget())
+		SetPendingFoothold(HitResult.Location, &HitResult);
+	}
+	else // If no ground is found, stretch it downwards TODO: This should be handled differently
+	{
+		SetPendingFoothold(EndLocation, nullptr);
+	}
+}
+
+void UIKLegComponent::RequestFootholdCandidates()
+{
+	// Predict where the step target will be once the foot lands, but never more than a step away
+	const FVector PredictedLocation = FIKLegGait::PredictFoothold(StepTarget->GetComponentLocation(), GetOwner()->GetVelocity(), GetInterpolationDuration(), GetStepDistance());
+
+	// The predicted point and a ring around it
+	FIKLegGait::MakeFootholdCandidates(PredictedLocation, GetStepDistance() * FootholdRingRadius, FootholdRingCandidates, FootholdCandidates);
+
+	// Async traces are batched by the engine and run together on the physics task, results are ready next frame
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(IKLegFootholdTrace), false, GetOwner());
+	QueryParams.bReturnPhysicalMaterial = true;
+	const FVector TraceExtent = FVector::UpVector * GetTotalLength() * GetMaxStepHeighPercentage();
+	FootholdTraces.Reset(FootholdCandidates.Num());
+	for (const FVector& Candidate : FootholdCandidates)
+	{
+		FootholdTraces.Add(GetWorld()->AsyncLineTraceByChannel(EAsyncTraceType::Single, Candidate + TraceExtent, Candidate - TraceExtent, ECC_Visibility, QueryParams));
+	}
+}
+
+bool UIKLegComponent::SelectFoothold()
+{
+	// Gather the hits, bail if the batch isn't done. Expired handles count as misses
+	TArray<const FHitResult*, TInlineAllocator<17>> Hits;
+	TArray<FTraceDatum, TInlineAllocator<17>> Data;
+	Data.SetNum(FootholdTraces.Num());
+	for (int32 i = 0; i < FootholdTraces.Num(); i++)
+	{
+		if (!GetWorld()->QueryTraceData(FootholdTraces[i], Data[i]) && GetWorld()->IsTraceHandleValid(FootholdTraces[i], false))
 		{
 			return false;
 		}
+		Hits.Add(Data[i].OutHits.Num() > 0 && Data[i].OutHits[0].bBlockingHit ? &Data[i].OutHits[0] : nullptr);
 	}
-	
-	// Calculate distances
-	const FVector StepTargetLocation = StepTarget->GetComponentLocation();
 
-	// If end effector target is too far from the step target
-	if(FVector::Distance(EndEffectorTargetLocation, StepTargetLocation) > StepDistance)
+	// Nothing usable came back, fall back to a single trace under the step target
+	if (Hits.Num() == 0 || !Hits.ContainsByPredicate([](const FHitResult* Hit) { return Hit != nullptr; }))
 	{
+		TraceStepTarget();
 		return true;
 	}
-	// If the last bone is too far from the step target
-	if(FVector::Distance(StepTargetLocation, Bones.Last().Transform.GetLocation()) > StepDistance)
+
+	// Score the candidates, see FIKLegGait::SelectFoothold
+	TArray<FIKFootholdSample, TInlineAllocator<17>> Samples;
+	for (const FHitResult* Hit : Hits)
 	{
-		return true;
+		FIKFootholdSample& Sample = Samples.AddDefaulted_GetRef();
+		if (Hit)
+		{
+			Sample.bHit = true;
+			Sample.Location = Hit->Location;
+			Sample.Normal = Hit->ImpactNormal;
+		}
 	}
-	// If EndEffectorTargetLocation if further than total length
-	if(FVector::Distance(EndEffectorTargetLocation, Bones[0].Transform.GetLocation()) > TotalLength)
+	const int32 BestIndex = FIKLegGait::SelectFoothold(Samples, FootholdCandidates[0], GetComponentLocation(), GetTotalLength(),
+		GetStepDistance() * FootholdRingRadius, MaxFootholdSlopeAngle, FootholdEdgeHeight);
+
+	if (BestIndex != INDEX_NONE)
 	{
-		return true;
+		SetPendingFoothold(Hits[BestIndex]->Location, Hits[BestIndex]);
 	}
+	else
+	{
+		// Every hit was rejected, take the predicted point as it is
+		const FHitResult* PredictedHit = Hits[0];
+		SetPendingFoothold(PredictedHit ? PredictedHit->Location : FootholdCandidates[0] - FVector::UpVector * GetTotalLength() * GetMaxStepHeighPercentage(), PredictedHit);
+	}
+	return true;
+}
+
+void UIKLegComponent::SetPendingFoothold(const FVector& Location, const FHitResult* SurfaceHit)
+{
+	TargetStepLocation = Location;
+	PendingFootstep.Location = Location;
+	PendingFootstep.bHasSurface = SurfaceHit != nullptr;
+	PendingFootstep.SurfaceNormal = SurfaceHit ? FVector(SurfaceHit->ImpactNormal) : FVector::UpVector;
+	PendingFootstep.SurfaceMaterial = SurfaceHit ? SurfaceHit->PhysMaterial : TWeakObjectPtr<UPhysicalMaterial>();
+}
+
+void UIKLegComponent::EmitFootstep(const FFootstepEvent& Event) const
+{
+	if(FootstepEvents)
+	{
+		FootstepEvents->EnqueueEvent(Event);
+	}
+}
 
-	return false;
+bool UIKLegComponent::ShouldMoveStepTarget() const
+{
+	// Check that no other legs are currently moving the step target
+	for (const TObjectPtr<UIKLegComponent> OtherLeg : OtherLegs)
+	{
+		if(OtherLeg->IsMovingStepTarget())
+		{
+			return false;
+		}
+	}
+	
+	return FIKLegGait::ShouldStep(EndEffectorTargetLocation, Bones.Last().Transform.GetLocation(), StepTarget->GetComponentLocation(),
+		Bones[0].Transform.GetLocation(), GetStepDistance(), GetTotalLength());
 }
\ No newline at end of file
@@ -0,0 +1,121 @@
+#include "IKLegGait.h"
+
+FVector FIKLegGait::GetStepTargetOffset(const FVector& StartOffset, const FVector& LocalMoveDirection, float StepDistance)
+{
+	return StartOffset + LocalMoveDirection * StepDistance;
+}
+
+bool FIKLegGait::ShouldStep(const FVector& EndEffectorTarget, const FVector& EndEffectorLocation, const FVector& StepTargetLocation,
+	const FVector& RootLocation, float StepDistance, float TotalLength)
+{
+	// If end effector target is too far from the step target
+	if(FVector::Distance(EndEffectorTarget, StepTargetLocation) > StepDistance)
+	{
+		return true;
+	}
+	// If the last bone is too far from the step target
+	if(FVector::Distance(StepTargetLocation, EndEffectorLocation) > StepDistance)
+	{
+		return true;
+	}
+	// If EndEffectorTargetLocation if further than total length
+	if(FVector::Distance(EndEffectorTarget, RootLocation) > TotalLength)
+	{
+		return true;
+	}
+
+	return false;
+}
+
+void FIKLegGait::EvaluateStepCurve(float Alpha, float EaseExponent, float StepHeight, float& OutHorizontalAlpha, float& OutVerticalOffset)
+{
+	OutHorizontalAlpha = FMath::InterpEaseInOut(0.0f, 1.0f, Alpha, EaseExponent);
+
+	// Calculate the vertical offset using a sine wave
+	OutVerticalOffset = FMath::Sin(Alpha * PI) * StepHeight;
+}
+
+FVector FIKLegGait::GetStepLocation(const FVector& Start, const FVector& Target, float HorizontalAlpha, float VerticalOffset)
+{
+	// Lerp between the start and target locations using the eased alpha
+	return FMath::Lerp(Start, Target, HorizontalAlpha) + FVector(0, 0, VerticalOffset);
+}
+
+FVector FIKLegGait::PredictFoothold(const FVector& StepTargetLocation, FVector Velocity, float InterpolationDuration, float StepDistance)
+{
+	Velocity.Z = 0.0f;
+	return StepTargetLocation + (Velocity * InterpolationDuration).GetClampedToMaxSize(StepDistance);
+}
+
+void FIKLegGait::MakeFootholdCandidates(const FVector& PredictedLocation, float RingRadius, int32 RingCandidates, TArray<FVector>& OutCandidates)
+{
+	OutCandidates.Reset(RingCandidates + 1);
+	OutCandidates.Add(PredictedLocation);
+	for (int32 i = 0; i < RingCandidates; i++)
+	{
+		const float Angle = 2.0f * PI * i / RingCandidates;
+		OutCandidates.Add(PredictedLocation + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * RingRadius);
+	}
+}
+
+int32 FIKLegGait::SelectFoothold(TConstArrayView<FIKFootholdSample> Samples, const FVector& PredictedLocation, const FVector& RootLocation,
+	float TotalLength, float RingRadius, float MaxSlopeAngle, float EdgeHeight)
+{
+	// True if the neighbouring candidate missed or is at a very different height, i.e. the candidate is near an edge
+	auto IsOverEdge = [&](int32 Candidate, int32 Neighbour)
+	{
+		return !Samples[Neighbour].bHit || FMath::Abs(Samples[Neighbour].Location.Z - Samples[Candidate].Location.Z) > EdgeHeight;
+	};
+
+	const float MinSurfaceNormalZ = FMath::Cos(FMath::DegreesToRadians(MaxSlopeAngle));
+	const float SafeRingRadius = FMath::Max(RingRadius, 1.0f);
+	const int32 RingCount = Samples.Num() - 1;
+
+	int32 BestIndex = INDEX_NONE;
+	float BestScore = TNumericLimits<float>::Max();
+	for (int32 i = 0; i < Samples.Num(); i++)
+	{
+		const FIKFootholdSample& Sample = Samples[i];
+		if (!Sample.bHit) continue;
+
+		// Too steep or out of reach
+		if (Sample.Normal.Z < MinSurfaceNormalZ) continue;
+		if (FVector::Distance(RootLocation, Sample.Location) > TotalLength) continue;
+
+		// Fraction of neighbours over an edge, the centre neighbours the whole ring, ring points their two ring neighbours and the centre
+		int32 EdgeCount = 0;
+		int32 NeighbourCount = 0;
+		if (i == 0)
+		{
+			for (int32 j = 1; j < Samples.Num(); j++)
+			{
+				EdgeCount += IsOverEdge(i, j) ? 1 : 0;
+				NeighbourCount++;
+			}
+		}
+		else
+		{
+			EdgeCount += IsOverEdge(i, 0) ? 1 : 0;
+			NeighbourCount++;
+			if (RingCount > 1)
+			{
+				EdgeCount += IsOverEdge(i, 1 + (i % RingCount)) ? 1 : 0; // Next, wrapping
+				EdgeCount += IsOverEdge(i, 1 + ((i + RingCount - 2) % RingCount)) ? 1 : 0; // Previous, wrapping
+				NeighbourCount += 2;
+			}
+		}
+		const float EdgeScore = NeighbourCount > 0 ? static_cast<float>(EdgeCount) / NeighbourCount : 0.0f;
+
+		// Lower is better, prefer flat ground away from edges close to the prediction
+		const float PredictionScore = FVector::Dist2D(Sample.Location, PredictedLocation) / SafeRingRadius;
+		const float SlopeScore = 1.0f - Sample.Normal.Z;
+		const float Score = PredictionScore + 2.0f * EdgeScore + SlopeScore;
+		if (Score < BestScore)
+		{
+			BestScore = Score;
+			BestIndex = i;
+		}
+	}
+
+	return BestIndex;
+}
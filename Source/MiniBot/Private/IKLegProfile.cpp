@@ -0,0 +1,96 @@
+#include "IKLegProfile.h"
+#include "IKLegGait.h"
+
+float FIKLegSettings::GetValue(EIKLegSetting Setting) const
+{
+	switch (Setting)
+	{
+	case EIKLegSetting::BoneCount: return BoneCount;
+	case EIKLegSetting::BoneLength: return BoneLength;
+	case EIKLegSetting::Iterations: return Iterations;
+	case EIKLegSetting::Tolerance: return Tolerance;
+	case EIKLegSetting::StepDistance: return StepDistance;
+	case EIKLegSetting::StepHeight: return StepHeight;
+	case EIKLegSetting::StepEaseCurveExponent: return StepEaseCurveExponent;
+	case EIKLegSetting::InterpolationDuration: return InterpolationDuration;
+	case EIKLegSetting::EndEffectorMaxSpeed: return EndEffectorMaxSpeed;
+	case EIKLegSetting::MaxStepHeighPercentage: return MaxStepHeighPercentage;
+	}
+	checkNoEntry();
+	return 0.0f;
+}
+
+void FIKLegSettings::SetValue(EIKLegSetting Setting, float Value)
+{
+	switch (Setting)
+	{
+	case EIKLegSetting::BoneCount: BoneCount = FMath::Max(FMath::RoundToInt32(Value), 1); break;
+	case EIKLegSetting::BoneLength: BoneLength = Value; break;
+	case EIKLegSetting::Iterations: Iterations = FMath::RoundToInt32(Value); break;
+	case EIKLegSetting::Tolerance: Tolerance = Value; break;
+	case EIKLegSetting::StepDistance: StepDistance = Value; break;
+	case EIKLegSetting::StepHeight: StepHeight = Value; break;
+	case EIKLegSetting::StepEaseCurveExponent: StepEaseCurveExponent = Value; break;
+	case EIKLegSetting::InterpolationDuration: InterpolationDuration = FMath::Max(Value, 0.01f); break;
+	case EIKLegSetting::EndEffectorMaxSpeed: EndEffectorMaxSpeed = Value; break;
+	case EIKLegSetting::MaxStepHeighPercentage: MaxStepHeighPercentage = FMath::Clamp(Value, 0.0f, 1.0f); break;
+	}
+}
+
+void UIKLegProfile::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	// Covers profiles created at runtime, loaded ones are rebuilt again in PostLoad
+	RebuildDerivedData();
+}
+
+void UIKLegProfile::PostLoad()
+{
+	Super::PostLoad();
+
+	RebuildDerivedData();
+}
+
+#if WITH_EDITOR
+void UIKLegProfile::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	RebuildDerivedData();
+	OnProfileChanged.Broadcast(this);
+}
+#endif
+
+void UIKLegProfile::EvaluateStepCurve(float Alpha, float& OutHorizontalAlpha, float& OutVerticalOffset) const
+{
+	// Linear interpolation between the two closest samples
+	const float SamplePosition = FMath::Clamp(Alpha, 0.0f, 1.0f) * (StepCurveSamples - 1);
+	const int32 Index = FMath::Min(FMath::FloorToInt32(SamplePosition), StepCurveSamples - 2);
+	const float Fraction = SamplePosition - Index;
+
+	OutHorizontalAlpha = FMath::Lerp(StepHorizontalCurve[Index], StepHorizontalCurve[Index + 1], Fraction);
+	OutVerticalOffset = FMath::Lerp(StepVerticalCurve[Index], StepVerticalCurve[Index + 1], Fraction);
+}
+
+void UIKLegProfile::RebuildDerivedData()
+{
+	// Bone lengths and total reach
+	BoneLengths.Reset(Settings.BoneCount + 1);
+	TotalLength = 0.0f;
+	for (int32 i = 0; i < Settings.BoneCount + 1; i++) // +1 for the root bone
+	{
+		const float Length = (i == 0) ? 0.0f : Settings.BoneLength; // Root bone has no length
+		BoneLengths.Add(Length);
+		TotalLength += Length;
+	}
+
+	// Step curve, eased horizontal movement and a sine arc for the foot lift
+	StepHorizontalCurve.SetNum(StepCurveSamples);
+	StepVerticalCurve.SetNum(StepCurveSamples);
+	for (int32 i = 0; i < StepCurveSamples; i++)
+	{
+		const float Alpha = static_cast<float>(i) / (StepCurveSamples - 1);
+		FIKLegGait::EvaluateStepCurve(Alpha, Settings.StepEaseCurveExponent, Settings.StepHeight, StepHorizontalCurve[i], StepVerticalCurve[i]);
+	}
+}
@@ -0,0 +1,87 @@
+#include "IKSolveWorker.h"
+#include "HAL/RunnableThread.h"
+#include "Misc/ScopeLock.h"
+
+FIKSolveWorker::FIKSolveWorker()
+	: bStopping(false)
+{
+	WorkEvent = FPlatformProcess::GetSynchEventFromPool(false);
+	Thread = FRunnableThread::Create(this, TEXT("IKSolveWorker"), 0, TPri_Normal);
+}
+
+FIKSolveWorker::~FIKSolveWorker()
+{
+	if (Thread)
+	{
+		Thread->Kill(true); // Calls Stop() and waits for Run() to return
+		delete Thread;
+		Thread = nullptr;
+	}
+
+	FPlatformProcess::ReturnSynchEventToPool(WorkEvent);
+	WorkEvent = nullptr;
+}
+
+uint32 FIKSolveWorker::Run()
+{
+	while (!bStopping)
+	{
+		WorkEvent->Wait();
+		if (bStopping) break;
+
+		// Copy the list and release the lock before solving, the copies keep unregistered pipelines alive until we're done
+		{
+			FScopeLock Lock(&PipelinesLock);
+			SolvingPipelines.Reset();
+			SolvingPipelines.Append(Pipelines);
+		}
+
+		for (const FIKLegSolvePipelinePtr& Pipeline : SolvingPipelines)
+		{
+			SolvePipeline(*Pipeline);
+		}
+		SolvingPipelines.Reset();
+	}
+
+	return 0;
+}
+
+void FIKSolveWorker::Stop()
+{
+	bStopping = true;
+	WorkEvent->Trigger();
+}
+
+void FIKSolveWorker::Kick()
+{
+	WorkEvent->Trigger();
+}
+
+void FIKSolveWorker::AddPipeline(const FIKLegSolvePipelinePtr& Pipeline)
+{
+	FScopeLock Lock(&PipelinesLock);
+	Pipelines.Add(Pipeline);
+}
+
+void FIKSolveWorker::RemovePipeline(const FIKLegSolvePipelinePtr& Pipeline)
+{
+	FScopeLock Lock(&PipelinesLock);
+	Pipelines.RemoveSwap(Pipeline);
+}
+
+void FIKSolveWorker::SolvePipeline(FIKLegSolvePipeline& Pipeline)
+{
+	// Nothing new was published since the last solve
+	if (!Pipeline.Input.IsDirty()) return;
+
+	const FIKLegSolveInput& Input = Pipeline.Input.SwapAndRead();
+	if (Input.Positions.Num() < 2) return;
+
+	// The write buffer keeps its allocation between swaps, so this doesn't reallocate once warmed up
+	FIKLegSolveOutput& Output = Pipeline.Output.GetWriteBuffer();
+	Output.RootTransform = Input.RootTransform;
+	Output.Generation = Input.Generation;
+	Output.Positions = Input.Positions;
+	Output.Result = Input.SolveFunction(Output.Positions, Input.BoneLengths, Input.Params);
+	Pipeline.Output.SwapWriteBuffers();
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/Runnable.h"
+#include "IKSolverSubsystem.h"
+
+// Dedicated thread solving every registered leg pipeline once per kick
+class FIKSolveWorker : public FRunnable
+{
+public:
+	FIKSolveWorker();
+	virtual ~FIKSolveWorker() override;
+
+	// FRunnable
+	virtual uint32 Run() override;
+	virtual void Stop() override;
+
+	// Wakes the worker to solve the latest snapshots
+	void Kick();
+
+	void AddPipeline(const FIKLegSolvePipelinePtr& Pipeline);
+	void RemovePipeline(const FIKLegSolvePipelinePtr& Pipeline);
+
+private:
+	void SolvePipeline(FIKLegSolvePipeline& Pipeline);
+
+	FRunnableThread* Thread = nullptr;
+	FEvent* WorkEvent = nullptr;
+	TAtomic<bool> bStopping;
+
+	// Guards Pipelines. The worker only holds it while copying the list into SolvingPipelines, never while solving,
+	// so registering or unregistering a leg on the game thread never waits on a solve
+	FCriticalSection PipelinesLock;
+	TArray<FIKLegSolvePipelinePtr> Pipelines;
+
+	// Worker thread only, keeps its allocation between kicks
+	TArray<FIKLegSolvePipelinePtr> SolvingPipelines;
+};
@@ -0,0 +1,55 @@
+#include "IKSolverSubsystem.h"
+#include "IKSolveWorker.h"
+
+UIKSolverSubsystem::UIKSolverSubsystem() = default;
+
+UIKSolverSubsystem::~UIKSolverSubsystem() = default;
+
+void UIKSolverSubsystem::Deinitialize()
+{
+	Worker.Reset();
+
+	Super::Deinitialize();
+}
+
+void UIKSolverSubsystem::Tick(float DeltaTime)
+{
+	Super::Tick(DeltaTime);
+
+	// Legs tick before tickable objects, so every leg has published this frame's snapshot by now
+	if (Worker)
+	{
+		Worker->Kick();
+	}
+}
+
+TStatId UIKSolverSubsystem::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(UIKSolverSubsystem, STATGROUP_Tickables);
+}
+
+FIKLegSolvePipelinePtr UIKSolverSubsystem::RegisterLeg()
+{
+	if (!FPlatformProcess::SupportsMultithreading())
+	{
+		return nullptr;
+	}
+
+	// Only start the thread once a leg actually wants it
+	if (!Worker)
+	{
+		Worker = MakeUnique<FIKSolveWorker>();
+	}
+
+	FIKLegSolvePipelinePtr Pipeline = MakeShared<FIKLegSolvePipeline, ESPMode::ThreadSafe>();
+	Worker->AddPipeline(Pipeline);
+	return Pipeline;
+}
+
+void UIKSolverSubsystem::UnregisterLeg(const FIKLegSolvePipelinePtr& Pipeline)
+{
+	if (Worker && Pipeline)
+	{
+		Worker->RemovePipeline(Pipeline);
+	}
+}
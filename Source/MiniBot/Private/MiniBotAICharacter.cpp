@@ -0,0 +1,17 @@
+#include "MiniBotAICharacter.h"
+#include "IKLegComponent.h"
+
+AMiniBotAICharacter::AMiniBotAICharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer
+		.DoNotCreateDefaultSubobject(AMiniBotCharacter::CameraBoomName)
+		.DoNotCreateDefaultSubobject(AMiniBotCharacter::FollowCameraName))
+{
+	// Possess with the AI controller both when placed and when spawned from the pool
+	AutoPossessAI = EAutoPossessAI::PlacedInWorldOrSpawned;
+
+	// One frame of leg latency isn't noticeable on AI bots, so keep their IK off the game thread
+	for (const TObjectPtr<UIKLegComponent>& Leg : Legs)
+	{
+		Leg->bSolveIKAsync = true;
+	}
+}
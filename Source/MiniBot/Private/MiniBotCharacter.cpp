@@ -4,6 +4,8 @@
 #include "EnhancedInputSubsystems.h"
 #include "IKLegComponent.h"
 #include "SmoothDynamicsIntegrator.h"
+#include "AIController.h"
+#include "BrainComponent.h"
 #include "Camera/CameraComponent.h"
 #include "Components/ArrowComponent.h"
 #include "Components/CapsuleComponent.h"
@@ -12,7 +14,11 @@
 #include "GameFramework/SpringArmComponent.h"
 
 
-AMiniBotCharacter::AMiniBotCharacter()
+FName AMiniBotCharacter::CameraBoomName(TEXT("CameraBoom"));
+FName AMiniBotCharacter::FollowCameraName(TEXT("FollowCamera"));
+
+AMiniBotCharacter::AMiniBotCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
 {
  	// Set this pawn to call Tick() every frame.  You can turn this off to improve performance if you don't need it.
 	PrimaryActorTick.bCanEverTick = true;
@@ -40,15 +46,28 @@ AMiniBotCharacter::AMiniBotCharacter()
 	GetArrowComponent()->SetScreenSize(1500);
 
 	// Create a camera boom (pulls in towards the player if there is a collision)
-	CameraBoom = CreateDefaultSubobject<USpringArmComponent>(TEXT("CameraBoom"));
-	CameraBoom->SetupAttachment(RootComponent);
-	CameraBoom->TargetArmLength = 400.0f; // The camera follows at this distance behind the character	
-	CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
+	CameraBoom = CreateOptionalDefaultSubobject<USpringArmComponent>(CameraBoomName);
+	if (CameraBoom)
+	{
+		CameraBoom->SetupAttachment(RootComponent);
+		CameraBoom->TargetArmLength = 400.0f; // The camera follows at this distance behind the character	
+		CameraBoom->bUsePawnControlRotation = true; // Rotate the arm based on the controller
+	}
 
 	// Create a follow camera
-	FollowCamera = CreateDefaultSubobject<UCameraComponent>(TEXT("FollowCamera"));
-	FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
-	FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
+	FollowCamera = CreateOptionalDefaultSubobject<UCameraComponent>(FollowCameraName);
+	if (FollowCamera)
+	{
+		if (CameraBoom)
+		{
+			FollowCamera->SetupAttachment(CameraBoom, USpringArmComponent::SocketName); // Attach the camera to the end of the boom and let the boom adjust to match the controller orientation
+		}
+		else
+		{
+			FollowCamera->SetupAttachment(RootComponent);
+		}
+		FollowCamera->bUsePawnControlRotation = false; // Camera does not rotate relative to arm
+	}
 	
 	BodyMesh = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("BodyMesh"));
 	BodyMesh->SetupAttachment(RootComponent);
@@ -72,12 +91,15 @@ void AMiniBotCharacter::BeginPlay()
 		}
 	}
 
-	// Initialize the BodyIntegrator component
-	BodyIntegrator = NewObject<USmoothDynamicsIntegrator>(this, USmoothDynamicsIntegrator::StaticClass());
+	// Initialize the BodyIntegrator component, pooled bots keep theirs between uses
+	if (!BodyIntegrator)
+	{
+		BodyIntegrator = NewObject<USmoothDynamicsIntegrator>(this, USmoothDynamicsIntegrator::StaticClass());
+	}
 	if (BodyIntegrator)
 	{
-		const FVector InitialBodyLocation = BodyMesh ? BodyMesh->GetRelativeLocation() : FVector::ZeroVector;
-		BodyIntegrator->Initialize(InitialBodyLocation, BodyResponseFrequency, BodyResponseDamping, BodyResponseUnderShoot);
+		BodyRestLocation = BodyMesh ? BodyMesh->GetRelativeLocation() : FVector::ZeroVector;
+		BodyIntegrator->Initialize(BodyRestLocation, BodyResponseFrequency, BodyResponseDamping, BodyResponseUnderShoot);
 	}
 
 	// Ensure that  legs are initialized
@@ -86,6 +108,18 @@ void AMiniBotCharacter::BeginPlay()
 	LegFrontLeft->Initialize(LegStepTargetFrontLeft, LegPoleFrontLeft, {LegBack, LegFrontRight});
 }
 
+void AMiniBotCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	// A controller held by a pooled bot isn't possessing anything, so nothing else would clean it up
+	if (IsValid(PooledController))
+	{
+		PooledController->Destroy();
+	}
+	PooledController = nullptr;
+
+	Super::EndPlay(EndPlayReason);
+}
+
 void AMiniBotCharacter::Tick(float DeltaTime)
 {
 	Super::Tick(DeltaTime);
@@ -131,6 +165,19 @@ void AMiniBotCharacter::Tick(float DeltaTime)
 		const FVector NewPosition = BodyIntegrator->Update(DeltaTime, TargetBodyLocation, FVector::ZeroVector);
 		BodyMesh->SetRelativeLocation(NewPosition);
 	}
+
+	UpdateDormancy(DeltaTime, TargetBodyLocation);
+}
+
+void AMiniBotCharacter::AddMovementInput(FVector WorldDirection, float ScaleValue, bool bForce)
+{
+	// Any movement input wakes the bot before it's consumed
+	if (bIsDormant && ScaleValue != 0.0f && !WorldDirection.IsZero())
+	{
+		WakeUp();
+	}
+
+	Super::AddMovementInput(WorldDirection, ScaleValue, bForce);
 }
 
 void AMiniBotCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputComponent)
@@ -187,6 +234,171 @@ void AMiniBotCharacter::Jump(const FInputActionValue& Value)
 {
 }
 
+void AMiniBotCharacter::UpdateDormancy(float DeltaTime, const FVector& TargetBodyLocation)
+{
+	if (!bAllowDormancy) return;
+
+	// No input, no movement and standing on the ground
+	const UCharacterMovementComponent* Movement = GetCharacterMovement();
+	bool bIsStill = Movement->GetLastInputVector().IsNearlyZero()
+		&& Movement->Velocity.IsNearlyZero()
+		&& Movement->IsMovingOnGround()
+		&& !IsPlayingRootMotion();
+
+	// Body has settled
+	bIsStill = bIsStill && BodyIntegrator && BodyIntegrator->IsSettled(TargetBodyLocation, BodySettleTolerance);
+
+	// All feet are planted and don't want to step
+	for (const TObjectPtr<UIKLegComponent>& Leg : Legs)
+	{
+		bIsStill = bIsStill && Leg && Leg->IsFootPlanted();
+	}
+
+	StillTime = bIsStill ? StillTime + DeltaTime : 0.0f;
+	if (StillTime >= DormancyDelay)
+	{
+		EnterDormancy();
+	}
+}
+
+void AMiniBotCharacter::EnterDormancy()
+{
+	bIsDormant = true;
+	StillTime = 0.0f;
+	DormantLocation = GetActorLocation();
+	DormantBase = GetMovementBase();
+
+	SetBotTickEnabled(false);
+
+	// Character movement keeps ticking, so let it tell us when something moves the bot
+	OnCharacterMovementUpdated.AddUniqueDynamic(this, &AMiniBotCharacter::OnDormantMovementUpdated);
+}
+
+void AMiniBotCharacter::WakeUp()
+{
+	if (!bIsDormant) return;
+
+	StopWatchingForWake();
+	SetBotTickEnabled(true);
+}
+
+void AMiniBotCharacter::StopWatchingForWake()
+{
+	bIsDormant = false;
+	StillTime = 0.0f;
+	OnCharacterMovementUpdated.RemoveDynamic(this, &AMiniBotCharacter::OnDormantMovementUpdated);
+}
+
+void AMiniBotCharacter::OnDormantMovementUpdated(float DeltaSeconds, FVector OldLocation, FVector OldVelocity)
+{
+	// Wake on velocity, root motion, being pushed or carried, or the ground changing underneath
+	const UCharacterMovementComponent* Movement = GetCharacterMovement();
+	if (!Movement->Velocity.IsNearlyZero()
+		|| IsPlayingRootMotion()
+		|| !Movement->IsMovingOnGround()
+		|| GetMovementBase() != DormantBase.Get()
+		|| !GetActorLocation().Equals(DormantLocation, BodySettleTolerance))
+	{
+		WakeUp();
+	}
+}
+
+void AMiniBotCharacter::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	bIsPooled = false;
+
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+
+	GetCharacterMovement()->Activate(true);
+	GetCharacterMovement()->SetMovementMode(MOVE_Walking);
+
+	ResetBotState();
+	SetBotTickEnabled(true);
+
+	// Hand the bot back to the controller it had before it was pooled
+	if (IsValid(PooledController))
+	{
+		AController* NewController = PooledController;
+		PooledController = nullptr;
+
+		NewController->SetActorTickEnabled(true);
+		NewController->Possess(this);
+		if (const AAIController* AIController = Cast<AAIController>(NewController); AIController && AIController->BrainComponent)
+		{
+			AIController->BrainComponent->RestartLogic();
+		}
+	}
+	// Otherwise only spawn one if a freshly spawned bot of this class would have gotten one
+	else if (!Controller && (AutoPossessAI == EAutoPossessAI::Spawned || AutoPossessAI == EAutoPossessAI::PlacedInWorldOrSpawned))
+	{
+		SpawnDefaultController();
+	}
+}
+
+void AMiniBotCharacter::DeactivateToPool()
+{
+	bIsPooled = true;
+
+	if (bIsDormant)
+	{
+		StopWatchingForWake();
+	}
+
+	// Keep AI controllers with the bot but stop their logic, spawning a new one on every activation would defeat the pool
+	if (AController* OldController = Controller; OldController && !OldController->IsPlayerController())
+	{
+		OldController->StopMovement();
+		if (const AAIController* AIController = Cast<AAIController>(OldController); AIController && AIController->BrainComponent)
+		{
+			AIController->BrainComponent->StopLogic(TEXT("Pooled"));
+		}
+		OldController->UnPossess();
+		OldController->SetActorTickEnabled(false);
+		PooledController = OldController;
+	}
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->Deactivate();
+
+	SetBotTickEnabled(false);
+	SetActorEnableCollision(false);
+	SetActorHiddenInGame(true);
+}
+
+void AMiniBotCharacter::ResetBotState()
+{
+	StillTime = 0.0f;
+
+	// Reset the body to its rest position and clear the integrator history
+	if (BodyMesh && BodyIntegrator)
+	{
+		BodyMesh->SetRelativeLocation(BodyRestLocation);
+		BodyIntegrator->Reset(BodyRestLocation);
+	}
+
+	for (const TObjectPtr<UIKLegComponent>& Leg : Legs)
+	{
+		if (Leg)
+		{
+			Leg->ResetLegState();
+		}
+	}
+}
+
+void AMiniBotCharacter::SetBotTickEnabled(bool bEnabled)
+{
+	SetActorTickEnabled(bEnabled);
+	for (const TObjectPtr<UIKLegComponent>& Leg : Legs)
+	{
+		if (Leg)
+		{
+			Leg->SetComponentTickEnabled(bEnabled);
+		}
+	}
+}
+
 void AMiniBotCharacter::SetupLegs()
 {
 	// Clear Legs array
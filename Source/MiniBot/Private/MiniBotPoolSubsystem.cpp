@@ -0,0 +1,73 @@
+#include "MiniBotPoolSubsystem.h"
+#include "MiniBotCharacter.h"
+#include "Engine/World.h"
+
+void UMiniBotPoolSubsystem::Deinitialize()
+{
+	Pools.Empty();
+
+	Super::Deinitialize();
+}
+
+void UMiniBotPoolSubsystem::Prewarm(TSubclassOf<AMiniBotCharacter> BotClass, int32 Count)
+{
+	if (!BotClass) return;
+
+	FMiniBotPool& Pool = Pools.FindOrAdd(BotClass.Get());
+	Pool.FreeBots.Reserve(Pool.FreeBots.Num() + Count);
+
+	for (int32 i = 0; i < Count; i++)
+	{
+		if (AMiniBotCharacter* Bot = SpawnBot(BotClass, FTransform::Identity))
+		{
+			Bot->DeactivateToPool();
+			Pool.FreeBots.Add(Bot);
+		}
+	}
+}
+
+AMiniBotCharacter* UMiniBotPoolSubsystem::AcquireBot(TSubclassOf<AMiniBotCharacter> BotClass, const FTransform& SpawnTransform)
+{
+	if (!BotClass) return nullptr;
+
+	// Reuse a free bot if there is one, skipping any that were destroyed while pooled
+	if (FMiniBotPool* Pool = Pools.Find(BotClass.Get()))
+	{
+		while (Pool->FreeBots.Num() > 0)
+		{
+			AMiniBotCharacter* Bot = Pool->FreeBots.Pop(false);
+			if (IsValid(Bot))
+			{
+				Bot->ActivateFromPool(SpawnTransform);
+				return Bot;
+			}
+		}
+	}
+
+	// Pool is empty, fall back to spawning
+	return SpawnBot(BotClass, SpawnTransform);
+}
+
+void UMiniBotPoolSubsystem::ReleaseBot(AMiniBotCharacter* Bot)
+{
+	if (!IsValid(Bot) || Bot->IsPooled()) return;
+
+	Bot->DeactivateToPool();
+	Pools.FindOrAdd(Bot->GetClass()).FreeBots.Add(Bot);
+}
+
+int32 UMiniBotPoolSubsystem::GetFreeBotCount(TSubclassOf<AMiniBotCharacter> BotClass) const
+{
+	const FMiniBotPool* Pool = Pools.Find(BotClass.Get());
+	return Pool ? Pool->FreeBots.Num() : 0;
+}
+
+AMiniBotCharacter* UMiniBotPoolSubsystem::SpawnBot(UClass* BotClass, const FTransform& SpawnTransform) const
+{
+	UWorld* World = GetWorld();
+	if (!World) return nullptr;
+
+	FActorSpawnParameters SpawnParameters;
+	SpawnParameters.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+	return World->SpawnActor<AMiniBotCharacter>(BotClass, SpawnTransform, SpawnParameters);
+}
@@ -0,0 +1,485 @@
+#include "MiniBotTuningCommandlet.h"
+#include "IKChainSolver.h"
+#include "IKLegComponent.h"
+#include "IKLegGait.h"
+#include "IKLegProfile.h"
+#include "SmoothDynamicsIntegrator.h"
+#include "Async/ParallelFor.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "UObject/StrongObjectPtr.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMiniBotTuning, Log, All);
+
+namespace MiniBotTuning
+{
+	struct FConfig
+	{
+		FIKLegSettings Leg;
+		float BodyFrequency = 2.0f;
+		float BodyDamping = 0.5f;
+		float BodyUnderShoot = 0.0f;
+	};
+
+	struct FOptions
+	{
+		float Duration = 20.0f;
+		float Speed = 300.0f;
+		float TerrainAmplitude = 20.0f;
+		float DeltaTime = 1.0f / 60.0f;
+		int32 TimingRepeats = 5;
+
+		// Foothold planning, taken from the UIKLegComponent defaults
+		bool bPredictFootholds = true;
+		int32 FootholdRingCandidates = 6;
+		float FootholdRingRadius = 0.35f;
+		float MaxFootholdSlopeAngle = 45.0f;
+		float FootholdEdgeHeight = 10.0f;
+	};
+
+	struct FResult
+	{
+		double SolverSeconds = 0.0;
+		int64 Solves = 0;
+		int64 Iterations = 0;
+		int32 Steps = 0;
+		float DistanceWalked = 0.0f;
+		float ReachError = 0.0f;
+		float BodyJitter = 0.0f;
+	};
+
+	// Every solve of one simulation, so the solver can be timed on its own by replaying them
+	struct FSolveRecording
+	{
+		struct FSolve
+		{
+			TArray<FVector3f> Positions;
+			FIKChainSolveParams3f Params;
+		};
+
+		TArray<float> BoneLengths;
+		FIKChainSolver3f::FSolveFunction SolveFunction = nullptr;
+		TArray<FSolve> Solves;
+	};
+
+	struct FLeg
+	{
+		FVector RootOffset;
+		FVector StepTargetOffset;
+		FVector PoleOffset;
+		TArray<FVector> Positions;
+		TArray<FVector3f> LocalPositions;
+		FVector EndEffectorTarget;
+		FVector StartStep;
+		FVector TargetStep;
+		float StepTime = 0.0f;
+		bool bStepping = false;
+		bool bPlanningFoothold = false;
+		TArray<FVector> FootholdCandidates;
+	};
+
+	// Rolling ground so steps and body height actually have something to react to
+	float GroundHeight(const FOptions& Options, const FVector& Location)
+	{
+		return Options.TerrainAmplitude * FMath::Sin(Location.X / 200.0f) * FMath::Cos(Location.Y / 300.0f);
+	}
+
+	FVector OnGround(const FOptions& Options, FVector Location)
+	{
+		Location.Z = GroundHeight(Options, Location);
+		return Location;
+	}
+
+	// Stands in for the leg's vertical ground traces, a hit if the ground is within Extent of the location
+	FIKFootholdSample TraceGround(const FOptions& Options, const FVector& Location, float Extent)
+	{
+		FIKFootholdSample Sample;
+		Sample.Location = OnGround(Options, Location);
+		Sample.bHit = FMath::Abs(Sample.Location.Z - Location.Z) <= Extent;
+
+		// Normal from the height gradient
+		const float Delta = 1.0f;
+		const float SlopeX = (GroundHeight(Options, Location + FVector(Delta, 0.0f, 0.0f)) - GroundHeight(Options, Location - FVector(Delta, 0.0f, 0.0f))) / (2.0f * Delta);
+		const float SlopeY = (GroundHeight(Options, Location + FVector(0.0f, Delta, 0.0f)) - GroundHeight(Options, Location - FVector(0.0f, Delta, 0.0f))) / (2.0f * Delta);
+		Sample.Normal = FVector(-SlopeX, -SlopeY, 1.0f).GetSafeNormal();
+		return Sample;
+	}
+
+	// Same as UIKLegComponent::TraceStepTarget, stretch downwards if there's no ground
+	FVector TraceStepTarget(const FOptions& Options, const FVector& StepTarget, float Extent)
+	{
+		const FIKFootholdSample Sample = TraceGround(Options, StepTarget, Extent);
+		return Sample.bHit ? Sample.Location : StepTarget - FVector::UpVector * Extent;
+	}
+
+	// Same as UIKLegComponent::SelectFoothold, traces are instant here but the step still waits a frame for them like in the game
+	FVector SelectFoothold(const FIKLegSettings& Settings, const FOptions& Options, const FLeg& Leg, const FVector& StepTarget, const FVector& RootLocation, float TotalLength)
+	{
+		const float Extent = TotalLength * Settings.MaxStepHeighPercentage;
+		TArray<FIKFootholdSample, TInlineAllocator<17>> Samples;
+		for (const FVector& Candidate : Leg.FootholdCandidates)
+		{
+			Samples.Add(TraceGround(Options, Candidate, Extent));
+		}
+
+		// Nothing usable came back, fall back to a single trace under the step target
+		if (!Samples.ContainsByPredicate([](const FIKFootholdSample& Sample) { return Sample.bHit; }))
+		{
+			return TraceStepTarget(Options, StepTarget, Extent);
+		}
+
+		const int32 BestIndex = FIKLegGait::SelectFoothold(Samples, Leg.FootholdCandidates[0], RootLocation, TotalLength,
+			Settings.StepDistance * Options.FootholdRingRadius, Options.MaxFootholdSlopeAngle, Options.FootholdEdgeHeight);
+		if (BestIndex != INDEX_NONE)
+		{
+			return Samples[BestIndex].Location;
+		}
+
+		// Every hit was rejected, take the predicted point as it is
+		return Samples[0].bHit ? Samples[0].Location : Leg.FootholdCandidates[0] - FVector::UpVector * Extent;
+	}
+
+	// Mirrors AMiniBotCharacter and UIKLegComponent with three legs walking in a straight line, without a world.
+	// Stepping goes through FIKLegGait like the legs do, so only the scene (terrain, traces, leg placement) is made up here.
+	// Solver time isn't measured here, pass a recording and replay it with TimeSolves instead
+	FResult Simulate(const FConfig& Config, const FOptions& Options, USmoothDynamicsIntegrator& BodyIntegrator, FSolveRecording* Recording = nullptr)
+	{
+		const FIKLegSettings& Settings = Config.Leg;
+		const float TotalLength = Settings.BoneCount * Settings.BoneLength;
+		const FVector MoveDirection = FVector::ForwardVector;
+		const FVector Velocity = MoveDirection * Options.Speed;
+		const float BodyHeight = TotalLength * 0.6f;
+
+		TArray<float> BoneLengths;
+		BoneLengths.Add(0.0f); // Root bone has no length
+		for (int32 i = 0; i < Settings.BoneCount; i++)
+		{
+			BoneLengths.Add(Settings.BoneLength);
+		}
+		const FIKChainSolver3f::FSolveFunction SolveFunction = FIKChainSolver3f::GetSolveFunction(Settings.BoneCount);
+
+		if (Recording)
+		{
+			Recording->BoneLengths = BoneLengths;
+			Recording->SolveFunction = SolveFunction;
+			Recording->Solves.Reset();
+		}
+
+		FIKChainSolveParams3f SolveParams;
+		SolveParams.Iterations = Settings.Iterations;
+		SolveParams.Tolerance = Settings.Tolerance;
+		SolveParams.bUsePole = true;
+
+		// Three legs spread evenly around the body like on the MiniBot, the step target rests on flat ground and the pole bends the knee up and out
+		FVector BodyLocation(0.0f, 0.0f, BodyHeight);
+		TArray<FLeg> Legs;
+		Legs.SetNum(3);
+		for (int32 i = 0; i < Legs.Num(); i++)
+		{
+			const float Angle = PI + 2.0f * PI * i / Legs.Num();
+			const FVector Direction(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f);
+			FLeg& Leg = Legs[i];
+			Leg.RootOffset = Direction * 30.0f;
+			Leg.StepTargetOffset = Direction * TotalLength * 0.6f - FVector::UpVector * BodyHeight;
+			Leg.PoleOffset = (Direction + FVector::UpVector) * TotalLength * 0.5f;
+			Leg.Positions.Init(BodyLocation + Leg.RootOffset, BoneLengths.Num());
+			Leg.LocalPositions.SetNum(BoneLengths.Num());
+			Leg.EndEffectorTarget = OnGround(Options, BodyLocation + Leg.RootOffset + Leg.StepTargetOffset);
+		}
+
+		FResult Result;
+		float BodyOffset = 0.0f;
+		float PreviousBodyOffset = 0.0f;
+		float PreviousBodyVelocity = 0.0f;
+		double JitterSum = 0.0;
+		double ReachErrorSum = 0.0;
+		int64 PlantedFrames = 0;
+
+		BodyIntegrator.Initialize(FVector::ZeroVector, Config.BodyFrequency, Config.BodyDamping, Config.BodyUnderShoot);
+
+		const int32 FrameCount = FMath::CeilToInt32(Options.Duration / Options.DeltaTime);
+		for (int32 Frame = 0; Frame < FrameCount; Frame++)
+		{
+			BodyLocation += MoveDirection * Options.Speed * Options.DeltaTime;
+			BodyLocation.Z = GroundHeight(Options, BodyLocation) + BodyHeight + BodyOffset;
+			Result.DistanceWalked += Options.Speed * Options.DeltaTime;
+
+			FVector FootCenter = FVector::ZeroVector;
+			FVector StepTargetCenter = FVector::ZeroVector;
+			for (FLeg& Leg : Legs)
+			{
+				const FVector RootLocation = BodyLocation + Leg.RootOffset;
+				const FVector StepTarget = RootLocation + FIKLegGait::GetStepTargetOffset(Leg.StepTargetOffset, MoveDirection, Settings.StepDistance);
+
+				// Same as UIKLegComponent::ShouldMoveStepTarget, one leg at a time. Legs tick in order so a leg that started this frame blocks the rest,
+				// and the last bone is snapped to the end effector target after every solve
+				const bool bOtherLegStepping = Legs.ContainsByPredicate([&Leg](const FLeg& Other) { return &Other != &Leg && Other.bStepping; });
+				if (Leg.bStepping || (!bOtherLegStepping
+					&& FIKLegGait::ShouldStep(Leg.EndEffectorTarget, Leg.EndEffectorTarget, StepTarget, RootLocation, Settings.StepDistance, TotalLength)))
+				{
+					// Same as UIKLegComponent::MoveStepTarget
+					bool bStepStarted = true;
+					if (Leg.StepTime == 0.0f)
+					{
+						if (Options.bPredictFootholds && !Leg.bPlanningFoothold)
+						{
+							// Send out the candidates and hold the step (and the other legs) until the next frame
+							const FVector Predicted = FIKLegGait::PredictFoothold(StepTarget, Velocity, Settings.InterpolationDuration, Settings.StepDistance);
+							FIKLegGait::MakeFootholdCandidates(Predicted, Settings.StepDistance * Options.FootholdRingRadius, Options.FootholdRingCandidates, Leg.FootholdCandidates);
+							Leg.bPlanningFoothold = true;
+							Leg.bStepping = true;
+							bStepStarted = false;
+						}
+						else
+						{
+							Leg.TargetStep = Options.bPredictFootholds
+								? SelectFoothold(Settings, Options, Leg, StepTarget, RootLocation, TotalLength)
+								: TraceStepTarget(Options, StepTarget, TotalLength * Settings.MaxStepHeighPercentage);
+							Leg.bPlanningFoothold = false;
+							Leg.StartStep = Leg.EndEffectorTarget;
+							Leg.bStepping = true;
+							Result.Steps++;
+						}
+					}
+
+					if (bStepStarted)
+					{
+						Leg.StepTime += Options.DeltaTime;
+						const float Alpha = FMath::Clamp(Leg.StepTime / Settings.InterpolationDuration, 0.0f, 1.0f);
+						float EasedAlpha;
+						float VerticalOffset;
+						FIKLegGait::EvaluateStepCurve(Alpha, Settings.StepEaseCurveExponent, Settings.StepHeight, EasedAlpha, VerticalOffset);
+						Leg.EndEffectorTarget = FIKLegGait::GetStepLocation(Leg.StartStep, Leg.TargetStep, EasedAlpha, VerticalOffset);
+						if (Alpha >= 1.0f)
+						{
+							Leg.StepTime = 0.0f;
+							Leg.bStepping = false;
+						}
+					}
+				}
+
+				// Root-local solve
+				for (int32 i = 0; i < Leg.Positions.Num(); i++)
+				{
+					Leg.LocalPositions[i] = FVector3f(Leg.Positions[i] - RootLocation);
+				}
+				SolveParams.TargetLocation = FVector3f(Leg.EndEffectorTarget - RootLocation);
+				SolveParams.PoleLocation = FVector3f(Leg.PoleOffset);
+
+				if (Recording)
+				{
+					Recording->Solves.Add({Leg.LocalPositions, SolveParams});
+				}
+
+				const FIKChainSolveResult SolveResult = SolveFunction(Leg.LocalPositions, BoneLengths, SolveParams);
+				Result.Solves++;
+				Result.Iterations += SolveResult.Iterations;
+
+				for (int32 i = 0; i < Leg.Positions.Num(); i++)
+				{
+					Leg.Positions[i] = RootLocation + FVector(Leg.LocalPositions[i]);
+				}
+
+				// How far the solved chain ends from a planted foot. The game snaps the last bone onto the target, so this shows up
+				// as the last bone stretching rather than the foot sliding
+				if (!Leg.bStepping)
+				{
+					ReachErrorSum += FVector::Distance(Leg.Positions.Last(), Leg.EndEffectorTarget);
+					PlantedFrames++;
+				}
+
+				FootCenter += Leg.Positions.Last();
+				StepTargetCenter += StepTarget;
+			}
+			FootCenter /= Legs.Num();
+			StepTargetCenter /= Legs.Num();
+
+			// Same body response as AMiniBotCharacter::Tick
+			const float HeightOffset = static_cast<float>(FootCenter.Z - StepTargetCenter.Z) / 2.0f;
+			BodyOffset = static_cast<float>(BodyIntegrator.Update(Options.DeltaTime, FVector(0.0f, 0.0f, BodyOffset + HeightOffset), FVector::ZeroVector).Z);
+
+			// Jitter is the body's vertical acceleration
+			const float BodyVelocity = (BodyOffset - PreviousBodyOffset) / Options.DeltaTime;
+			if (Frame > 0)
+			{
+				JitterSum += FMath::Square((BodyVelocity - PreviousBodyVelocity) / Options.DeltaTime);
+			}
+			PreviousBodyOffset = BodyOffset;
+			PreviousBodyVelocity = BodyVelocity;
+		}
+
+		Result.ReachError = PlantedFrames > 0 ? static_cast<float>(ReachErrorSum / PlantedFrames) : 0.0f;
+		Result.BodyJitter = FrameCount > 1 ? static_cast<float>(FMath::Sqrt(JitterSum / (FrameCount - 1))) : 0.0f;
+		return Result;
+	}
+
+	// Replays every recorded solve back to back and returns the fastest of Repeats runs. A single solve is close to the timer's
+	// resolution, so only whole batches are timed, and this should run on an otherwise idle machine
+	double TimeSolves(const FSolveRecording& Recording, int32 Repeats)
+	{
+		TArray<TArray<FVector3f>> Positions;
+		Positions.SetNum(Recording.Solves.Num());
+
+		double BestSeconds = TNumericLimits<double>::Max();
+		for (int32 Repeat = 0; Repeat < Repeats; Repeat++)
+		{
+			// Solves work in place, so restore the inputs first, outside of the timed region
+			for (int32 i = 0; i < Recording.Solves.Num(); i++)
+			{
+				Positions[i] = Recording.Solves[i].Positions;
+			}
+
+			const uint64 StartCycles = FPlatformTime::Cycles64();
+			for (int32 i = 0; i < Recording.Solves.Num(); i++)
+			{
+				Recording.SolveFunction(Positions[i], Recording.BoneLengths, Recording.Solves[i].Params);
+			}
+			BestSeconds = FMath::Min(BestSeconds, FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles));
+		}
+		return Recording.Solves.Num() > 0 ? BestSeconds : 0.0;
+	}
+
+	TArray<float> ParseGridValues(const FString& Params, const TCHAR* Name, float DefaultValue)
+	{
+		TArray<float> Values;
+		FString ValueList;
+		if (FParse::Value(*Params, *FString::Printf(TEXT("-%s="), Name), ValueList, false))
+		{
+			TArray<FString> Entries;
+			ValueList.ParseIntoArray(Entries, TEXT(","));
+			for (const FString& Entry : Entries)
+			{
+				Values.Add(FCString::Atof(*Entry));
+			}
+		}
+		if (Values.Num() == 0)
+		{
+			Values.Add(DefaultValue);
+		}
+		return Values;
+	}
+}
+
+UMiniBotTuningCommandlet::UMiniBotTuningCommandlet()
+{
+	IsClient = false;
+	IsServer = false;
+	IsEditor = false;
+	LogToConsole = true;
+
+	HelpDescription = TEXT("Sweeps MiniBot gait and solver settings in headless simulations and reports cost and quality per configuration");
+	HelpUsage = TEXT("-run=MiniBotTuning -BoneCount=2,3 -BoneLength=100 -Iterations=5,10 -Tolerance=0.01 -StepDistance=100 -InterpolationDuration=0.15 -BodyFrequency=2 -BodyDamping=0.5 -BodyUnderShoot=0 -SimSeconds=20");
+}
+
+int32 UMiniBotTuningCommandlet::Main(const FString& Params)
+{
+	using namespace MiniBotTuning;
+
+	// Defaults come from the leg settings struct so the sweep starts from what the game uses
+	const FIKLegSettings DefaultLeg;
+	const TArray<float> BoneCountValues = ParseGridValues(Params, TEXT("BoneCount"), DefaultLeg.BoneCount);
+	const TArray<float> BoneLengthValues = ParseGridValues(Params, TEXT("BoneLength"), DefaultLeg.BoneLength);
+	const TArray<float> IterationValues = ParseGridValues(Params, TEXT("Iterations"), DefaultLeg.Iterations);
+	const TArray<float> ToleranceValues = ParseGridValues(Params, TEXT("Tolerance"), DefaultLeg.Tolerance);
+	const TArray<float> StepDistanceValues = ParseGridValues(Params, TEXT("StepDistance"), DefaultLeg.StepDistance);
+	const TArray<float> InterpolationDurationValues = ParseGridValues(Params, TEXT("InterpolationDuration"), DefaultLeg.InterpolationDuration);
+	const TArray<float> FrequencyValues = ParseGridValues(Params, TEXT("BodyFrequency"), 2.0f);
+	const TArray<float> DampingValues = ParseGridValues(Params, TEXT("BodyDamping"), 0.5f);
+	const TArray<float> UnderShootValues = ParseGridValues(Params, TEXT("BodyUnderShoot"), 0.0f);
+
+	FOptions Options;
+	// FParse::Value matches anywhere in the command line, so keys keep their dash and mustn't end another key (Duration would match -InterpolationDuration)
+	FParse::Value(*Params, TEXT("-SimSeconds="), Options.Duration);
+	FParse::Value(*Params, TEXT("-Speed="), Options.Speed);
+	FParse::Value(*Params, TEXT("-Terrain="), Options.TerrainAmplitude);
+	FParse::Value(*Params, TEXT("-TimingRepeats="), Options.TimingRepeats);
+	Options.TimingRepeats = FMath::Max(Options.TimingRepeats, 1);
+
+	const UIKLegComponent* DefaultComponent = GetDefault<UIKLegComponent>();
+	Options.bPredictFootholds = DefaultComponent->bPredictFootholds;
+	Options.FootholdRingCandidates = DefaultComponent->FootholdRingCandidates;
+	Options.FootholdRingRadius = DefaultComponent->FootholdRingRadius;
+	Options.MaxFootholdSlopeAngle = DefaultComponent->MaxFootholdSlopeAngle;
+	Options.FootholdEdgeHeight = DefaultComponent->FootholdEdgeHeight;
+	FParse::Bool(*Params, TEXT("-PredictFootholds="), Options.bPredictFootholds);
+
+	// Every combination of the grid
+	TArray<FConfig> Configs;
+	for (const float BoneCount : BoneCountValues)
+	for (const float BoneLength : BoneLengthValues)
+	for (const float Iterations : IterationValues)
+	for (const float Tolerance : ToleranceValues)
+	for (const float StepDistance : StepDistanceValues)
+	for (const float InterpolationDuration : InterpolationDurationValues)
+	for (const float Frequency : FrequencyValues)
+	for (const float Damping : DampingValues)
+	for (const float UnderShoot : UnderShootValues)
+	{
+		FConfig& Config = Configs.AddDefaulted_GetRef();
+		Config.Leg.BoneCount = FMath::Max(FMath::RoundToInt32(BoneCount), 1);
+		Config.Leg.BoneLength = FMath::Max(BoneLength, 1.0f);
+		Config.Leg.Iterations = FMath::Max(FMath::RoundToInt32(Iterations), 1);
+		Config.Leg.Tolerance = Tolerance;
+		Config.Leg.StepDistance = StepDistance;
+		Config.Leg.InterpolationDuration = FMath::Max(InterpolationDuration, Options.DeltaTime);
+		Config.BodyFrequency = FMath::Max(Frequency, KINDA_SMALL_NUMBER);
+		Config.BodyDamping = Damping;
+		Config.BodyUnderShoot = UnderShoot;
+	}
+
+	UE_LOG(LogMiniBotTuning, Display, TEXT("Simulating %d configurations for %.1f seconds each"), Configs.Num(), Options.Duration);
+
+	// Integrators are UObjects, so create them here on the game thread. Updating them is plain math and safe to run in parallel
+	TArray<TStrongObjectPtr<USmoothDynamicsIntegrator>> Integrators;
+	for (int32 i = 0; i < Configs.Num(); i++)
+	{
+		Integrators.Emplace(NewObject<USmoothDynamicsIntegrator>(GetTransientPackage()));
+	}
+
+	TArray<FResult> Results;
+	Results.SetNum(Configs.Num());
+	ParallelFor(Configs.Num(), [&](int32 Index)
+	{
+		Results[Index] = Simulate(Configs[Index], Options, *Integrators[Index]);
+	});
+
+	// Solver timing in a separate single threaded pass, so it isn't skewed by the sweep filling every core. Each configuration is
+	// simulated again to record its solves, which is deterministic and gives the same solves as above
+	UE_LOG(LogMiniBotTuning, Display, TEXT("Timing solvers, %d repeats per configuration"), Options.TimingRepeats);
+	FSolveRecording Recording;
+	for (int32 i = 0; i < Configs.Num(); i++)
+	{
+		Simulate(Configs[i], Options, *Integrators[i], &Recording);
+		Results[i].SolverSeconds = TimeSolves(Recording, Options.TimingRepeats);
+	}
+
+	// Report
+	FString Csv = TEXT("BoneCount,BoneLength,Iterations,Tolerance,StepDistance,InterpolationDuration,BodyFrequency,BodyDamping,BodyUnderShoot,SolverTimeMs,SolveTimeNs,MeanIterations,Steps,StepsPerMetre,ReachError,BodyJitter\n");
+	for (int32 i = 0; i < Configs.Num(); i++)
+	{
+		const FConfig& Config = Configs[i];
+		const FResult& Result = Results[i];
+		const double SolveTimeNs = Result.Solves > 0 ? Result.SolverSeconds * 1.0e9 / Result.Solves : 0.0;
+		const double MeanIterations = Result.Solves > 0 ? static_cast<double>(Result.Iterations) / Result.Solves : 0.0;
+		const double StepsPerMetre = Result.DistanceWalked > 0.0f ? Result.Steps / (Result.DistanceWalked / 100.0) : 0.0;
+
+		const FString Row = FString::Printf(TEXT("%d,%g,%d,%g,%g,%g,%g,%g,%g,%.3f,%.1f,%.2f,%d,%.3f,%.3f,%.3f"),
+			Config.Leg.BoneCount, Config.Leg.BoneLength, Config.Leg.Iterations, Config.Leg.Tolerance, Config.Leg.StepDistance, Config.Leg.InterpolationDuration,
+			Config.BodyFrequency, Config.BodyDamping, Config.BodyUnderShoot,
+			Result.SolverSeconds * 1000.0, SolveTimeNs, MeanIterations, Result.Steps, StepsPerMetre, Result.ReachError, Result.BodyJitter);
+		UE_LOG(LogMiniBotTuning, Display, TEXT("%s"), *Row);
+		Csv += Row + TEXT("\n");
+	}
+
+	FString OutputPath = FPaths::ProjectSavedDir() / TEXT("Tuning") / TEXT("MiniBotTuning.csv");
+	FParse::Value(*Params, TEXT("-Output="), OutputPath);
+	if (!FFileHelper::SaveStringToFile(Csv, *OutputPath))
+	{
+		UE_LOG(LogMiniBotTuning, Error, TEXT("Failed to write %s"), *OutputPath);
+		return 1;
+	}
+
+	UE_LOG(LogMiniBotTuning, Display, TEXT("Wrote %s"), *OutputPath);
+	return 0;
+}
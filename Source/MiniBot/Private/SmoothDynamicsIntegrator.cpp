@@ -21,11 +21,22 @@ void USmoothDynamicsIntegrator::Initialize(const FVector& InitialPosition, float
 	K2 = 1 / ((2 * PI * ResponseFrequency) * (2 * PI * ResponseFrequency));
 	K3 = ResponseUnderShoot * ResponseDamping / (2 * PI * ResponseFrequency);
 
+	Reset(X0);
+}
+
+void USmoothDynamicsIntegrator::Reset(const FVector& InitialPosition)
+{
+	X0 = InitialPosition;
 	Previous = X0;
 	Current = X0;
 	Delta = FVector::ZeroVector;
 }
 
+bool USmoothDynamicsIntegrator::IsSettled(const FVector& TargetPosition, float Tolerance) const
+{
+	return FVector::Distance(Current, TargetPosition) < Tolerance && Delta.Size() < Tolerance;
+}
+
 FVector USmoothDynamicsIntegrator::Update(float DeltaTime, const FVector& TargetPosition, FVector Velocity)
 {
 	if (Velocity.IsZero())
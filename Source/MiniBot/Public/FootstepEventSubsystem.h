@@ -0,0 +1,75 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "FootstepEventSubsystem.generated.h"
+
+class UIKLegComponent;
+class UPhysicalMaterial;
+
+UENUM(BlueprintType)
+enum class EFootstepEventType : uint8
+{
+	LiftOff,
+	Plant
+};
+
+USTRUCT(BlueprintType)
+struct FFootstepEvent
+{
+	GENERATED_BODY()
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footstep")
+	EFootstepEventType Type = EFootstepEventType::Plant;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footstep")
+	FVector Location = FVector::ZeroVector;
+
+	// Surface the foot lifted off from or planted on, only valid if bHasSurface is set
+	UPROPERTY(BlueprintReadOnly, Category = "Footstep")
+	bool bHasSurface = false;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footstep")
+	FVector SurfaceNormal = FVector::UpVector;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footstep")
+	TWeakObjectPtr<UPhysicalMaterial> SurfaceMaterial;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footstep")
+	TWeakObjectPtr<UIKLegComponent> Leg;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Footstep")
+	TWeakObjectPtr<AActor> Bot;
+};
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnFootstepBatch, TConstArrayView<FFootstepEvent>);
+
+// Collects footstep events from all legs and hands them out once per frame as a single batch,
+// so consumers pay one call per frame instead of one per foot
+UCLASS()
+class MINIBOT_API UFootstepEventSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Game thread only, legs step during their component tick
+	void EnqueueEvent(const FFootstepEvent& Event);
+
+	// Events gathered during the last frame, valid until the next subsystem tick
+	UFUNCTION(BlueprintCallable, Category = "Footstep")
+	const TArray<FFootstepEvent>& GetFrameEvents() const { return FrameEvents; }
+
+	// Broadcast once per frame with every event from that frame, skipped when there were none
+	FOnFootstepBatch OnFootstepBatch;
+
+private:
+	// Swapped on drain, so both keep their allocations and events are never copied after being queued
+	TArray<FFootstepEvent> PendingEvents;
+	TArray<FFootstepEvent> FrameEvents;
+
+	static constexpr int32 InitialEventCapacity = 256;
+};
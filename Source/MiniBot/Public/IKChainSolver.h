@@ -0,0 +1,57 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Inputs for a single chain solve, everything the solver needs besides the joint positions and bone lengths
+template<typename T>
+struct TIKChainSolveParams
+{
+	using FVectorType = UE::Math::TVector<T>;
+
+	FVectorType RootLocation = FVectorType::ZeroVector;
+	FVectorType TargetLocation = FVectorType::ZeroVector;
+	FVectorType PoleLocation = FVectorType::ZeroVector;
+	bool bUsePole = false;
+	int32 Iterations = 10;
+	T Tolerance = 0.01f;
+};
+
+// World space double precision, and root-local single precision
+typedef TIKChainSolveParams<double> FIKChainSolveParams;
+typedef TIKChainSolveParams<float> FIKChainSolveParams3f;
+
+struct FIKChainSolveResult
+{
+	int32 Iterations = 0;
+	bool bConverged = false;
+};
+
+// Stateless FABRIK solver, shared by UIKLegComponent and the async IK worker so it must not touch UObjects
+template<typename T>
+class TIKChainSolver
+{
+public:
+	using FVectorType = UE::Math::TVector<T>;
+	using FParams = TIKChainSolveParams<T>;
+
+	typedef FIKChainSolveResult (*FSolveFunction)(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths, const FParams& Params);
+
+	// Returns a solver unrolled for the given bone count if there is one, otherwise the generic solver.
+	// Chains don't change length at runtime, so callers should look this up once and keep it
+	static FSolveFunction GetSolveFunction(int32 BoneCount);
+
+	// Solves the chain in place. Positions[0] is the root joint, BoneLengths[i] is the length from joint i - 1 to joint i
+	static FIKChainSolveResult Solve(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths, const FParams& Params);
+	static FIKChainSolveResult SolveGeneric(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths, const FParams& Params);
+
+	static void ForwardsSolve(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths);
+	static void BackwardsSolve(TArray<FVectorType>& Positions, const TArray<float>& BoneLengths, const FVectorType& TargetLocation);
+	static void MoveTowardsPole(TArray<FVectorType>& Positions, const FVectorType& PoleLocation);
+};
+
+// Instantiated in IKChainSolver.cpp
+extern template class TIKChainSolver<double>;
+extern template class TIKChainSolver<float>;
+
+typedef TIKChainSolver<double> FIKChainSolver;
+typedef TIKChainSolver<float> FIKChainSolver3f;
@@ -3,8 +3,14 @@
 #include "CoreMinimal.h"
 #include "Components/SceneComponent.h"
 #include "Components/SphereComponent.h"
+#include "WorldCollision.h"
+#include "IKChainSolver.h"
+#include "FootstepEventSubsystem.h"
+#include "IKLegProfile.h"
 #include "IKLegComponent.generated.h"
 
+class FIKLegSolvePipeline;
+
 USTRUCT(BlueprintType)
 struct FBone
 {
@@ -14,9 +20,6 @@ public:
     UPROPERTY(/*EditAnywhere, BlueprintReadWrite, Category = "IK"*/)
     FTransform Transform;
 
-    UPROPERTY(/*EditAnywhere, BlueprintReadWrite, Category = "IK"*/)
-    float BoneLength;
-
     UPROPERTY(/*EditAnywhere, BlueprintReadWrite, Category = "IK"*/)
     FVector AxisOfRotation; // Not used yet, but planned for future enhancements
 };
@@ -31,16 +34,20 @@ public:
 
 protected:
     virtual void BeginPlay() override;
+    virtual void PostLoad() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
     virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
 public:
-    // IK setup properties
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IK")
-    int32 BoneCount = 2;
+    // Shared leg settings, without one the FIKLegSettings defaults are used
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+    TObjectPtr<UIKLegProfile> Profile;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IK")
-    float BoneLength = 100.0f;
+    // Settings this leg changes from its profile, read them through the Get functions below
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+    TArray<FIKLegSettingOverride> Overrides;
 
+    // IK setup properties
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IK")
     USphereComponent* StepTarget;
 
@@ -50,38 +57,48 @@ public:
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "IK")
     FVector EndEffectorTargetLocation;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IK")
-    int32 Iterations = 10;
+    // Solve on the IK worker thread instead of the game thread, the bones lag one frame behind.
+    // The worker always solves in root-local single precision
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+    bool bSolveIKAsync = false;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IK")
-    float Tolerance = 0.01f;
+    // Solve relative to the leg root in single precision, only converting to world space before and after the solve
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+    bool bSolveInRootSpace = true;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "IK")
     TArray<FBone> Bones;
 
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
-    float StepDistance = 100.0f;
-    
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
-    float StepHeight = 25.0f;
-    
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
-    float StepEaseCurveExponent = 2.0f;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadWrite, Category = "IK")
-    float TotalLength;
-
     void Initialize(USphereComponent* InStepTarget, USphereComponent* InPole, TArray<TObjectPtr<UIKLegComponent>> InOtherLegs);
     void MoveStepTarget(float DeltaTime);
+
+    // Resets bones and stepping state in place, used when a pooled bot is reused
+    void ResetLegState();
+
+    // Rebuilds the bones from the profile's current layout, called when the profile is edited while playing
+    void OnProfileChanged(const UIKLegProfile* ChangedProfile);
     
     UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IK")
     FVector PolePositionOffset;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IK")
-    float EndEffectorMaxSpeed = 0.01f;
+    // Foothold planning, predicts where the foot should land from the owner's velocity and picks the best of several candidates
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK|Foothold")
+    bool bPredictFootholds = true;
 
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "IK", meta = (ClampMin = "0.0", ClampMax = "1.0"))
-    float MaxStepHeighPercentage = 0.5f;
+    // Number of candidates in the ring around the predicted foothold, the predicted point itself is always a candidate
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK|Foothold", meta = (ClampMin = "0", ClampMax = "16"))
+    int32 FootholdRingCandidates = 6;
+
+    // Radius of the candidate ring as a fraction of the step distance
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK|Foothold", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+    float FootholdRingRadius = 0.35f;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK|Foothold", meta = (ClampMin = "0.0", ClampMax = "90.0"))
+    float MaxFootholdSlopeAngle = 45.0f;
+
+    // Height difference to a neighbouring candidate above which the neighbour counts as over an edge
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK|Foothold", meta = (ClampMin = "0.0"))
+    float FootholdEdgeHeight = 10.0f;
 
     UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "IK", meta = (AllowPrivateAccess = "true"))
     TArray<TObjectPtr<UIKLegComponent>> OtherLegs;
@@ -89,9 +106,6 @@ public:
     UPROPERTY()
     TArray<FVector> BonePositions;
 
-    UPROPERTY()
-    TArray<FQuat> BoneRotations;
-
     // Debug properties
     UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IKDebug")
     bool bDrawJoints = false;
@@ -107,20 +121,58 @@ public:
 private:
     // IK functions
     void SolveIK();
-    void ForwardsSolve();
-    void BackwardsSolve();
-    void MoveTowardsPole();
+    void ApplyBonePositions();
+    FIKChainSolveParams MakeSolveParams() const;
+    FIKChainSolveParams3f MakeLocalSolveParams(const FTransform& RootTransform) const;
+    void GatherLocalBonePositions(const FTransform& RootTransform, TArray<FVector3f>& OutPositions) const;
+    void SetBonePositionsFromLocal(const FTransform& RootTransform, const TArray<FVector3f>& InPositions);
+
+    // Picked in Initialize from the bone count, unrolled for common counts
+    FIKChainSolver::FSolveFunction SolveFunction = &FIKChainSolver::SolveGeneric;
+    FIKChainSolver3f::FSolveFunction LocalSolveFunction = &FIKChainSolver3f::SolveGeneric;
+    TArray<FVector3f> LocalBonePositions;
+
+    // Async IK functions
+    void PublishSolveSnapshot();
+    void ConsumeSolveResult();
+    TSharedPtr<FIKLegSolvePipeline, ESPMode::ThreadSafe> SolvePipeline;
+    uint32 SolveGeneration = 0; // Bumped by ResetLegState so results still in flight from before are ignored
+
+    FDelegateHandle ProfileChangedHandle;
 
     void DrawDebug();
-    bool ShouldMoveStepTarget();
+    bool ShouldMoveStepTarget() const;
     
+    // Foothold functions
+    void TraceStepTarget();
+    void RequestFootholdCandidates();
+    bool SelectFoothold();
+    void SetPendingFoothold(const FVector& Location, const FHitResult* SurfaceHit);
+
+    // Plants the foot on the ground under the step target and forces a step that only lands, for spawning and pool reuse
+    void PlantOnGround();
+
+    // Foothold candidates whose traces are in flight, index 0 is the predicted point
+    bool bIsPlanningFoothold = false;
+    TArray<FVector> FootholdCandidates;
+    TArray<FTraceHandle> FootholdTraces;
+
     // Properties for managing dynamic step target movement
-    bool bIsMovingStepTarget;
+    bool bIsMovingStepTarget = false;
     float CurrentInterpolationTime = 0.0f;
-    float InterpolationDuration = 0.15f;
     FVector StartStepLocation;
     FVector TargetStepLocation;
     FVector StepTargetStartOffset;
+
+    // Footstep events, PlantedFootstep describes where the foot currently stands and PendingFootstep where it will land
+    void EmitFootstep(const FFootstepEvent& Event) const;
+    FFootstepEvent PlantedFootstep;
+    FFootstepEvent PendingFootstep;
+    // Set for the step forced by PlantOnGround, the foot wasn't standing anywhere to lift off from
+    bool bSkipLiftOff = false;
+
+    UPROPERTY()
+    TObjectPtr<UFootstepEventSubsystem> FootstepEvents;
     
     UFUNCTION()
     bool IsMovingStepTarget() const { return bIsMovingStepTarget; }
@@ -135,5 +187,110 @@ public:
     FVector GetEndEffectorLocation() const { return  Bones.Last().Transform.GetLocation(); }
     UFUNCTION()
     FVector GetStepTargetStartOffset() const { return StepTargetStartOffset; }
+    UFUNCTION()
+    bool IsFootPlanted() const { return !bIsMovingStepTarget && Bones.Num() >= 2 && !ShouldMoveStepTarget(); }
+
+    // Effective settings, taken from the profile unless overridden on this leg
+    UFUNCTION(BlueprintPure, Category = "IK")
+    int32 GetBoneCount() const { return ResolveSetting(EIKLegSetting::BoneCount, &FIKLegSettings::BoneCount); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetBoneLength() const { return ResolveSetting(EIKLegSetting::BoneLength, &FIKLegSettings::BoneLength); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    int32 GetIterations() const { return ResolveSetting(EIKLegSetting::Iterations, &FIKLegSettings::Iterations); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetTolerance() const { return ResolveSetting(EIKLegSetting::Tolerance, &FIKLegSettings::Tolerance); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetStepDistance() const { return ResolveSetting(EIKLegSetting::StepDistance, &FIKLegSettings::StepDistance); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetStepHeight() const { return ResolveSetting(EIKLegSetting::StepHeight, &FIKLegSettings::StepHeight); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetStepEaseCurveExponent() const { return ResolveSetting(EIKLegSetting::StepEaseCurveExponent, &FIKLegSettings::StepEaseCurveExponent); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetInterpolationDuration() const { return ResolveSetting(EIKLegSetting::InterpolationDuration, &FIKLegSettings::InterpolationDuration); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetEndEffectorMaxSpeed() const { return ResolveSetting(EIKLegSetting::EndEffectorMaxSpeed, &FIKLegSettings::EndEffectorMaxSpeed); }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetTotalLength() const { return UsesProfileBones() ? Profile->GetTotalLength() : TotalLength; }
+    UFUNCTION(BlueprintPure, Category = "IK")
+    float GetMaxStepHeighPercentage() const { return ResolveSetting(EIKLegSetting::MaxStepHeighPercentage, &FIKLegSettings::MaxStepHeighPercentage); }
+
+    // Overrides the setting on this leg, a bone layout change takes effect on the next Initialize
+    UFUNCTION(BlueprintCallable, Category = "IK")
+    void SetOverride(EIKLegSetting Setting, float Value);
+    UFUNCTION(BlueprintCallable, Category = "IK")
+    void ClearOverride(EIKLegSetting Setting);
+    UFUNCTION(BlueprintPure, Category = "IK")
+    bool HasOverride(EIKLegSetting Setting) const { return FindOverride(Setting) != nullptr; }
+
+private:
+    // The profile's settings, or the struct defaults for legs without a profile
+    const FIKLegSettings& GetBaseSettings() const;
+    const FIKLegSettingOverride* FindOverride(EIKLegSetting Setting) const
+    {
+        return Overrides.FindByPredicate([Setting](const FIKLegSettingOverride& Override) { return Override.Setting == Setting; });
+    }
+
+    template<typename T>
+    T ResolveSetting(EIKLegSetting Setting, T FIKLegSettings::* Member) const
+    {
+        if (const FIKLegSettingOverride* Override = FindOverride(Setting))
+        {
+            // Goes through SetValue so overrides are rounded and clamped the same way everywhere
+            FIKLegSettings Resolved;
+            Resolved.SetValue(Setting, Override->Value);
+            return Resolved.*Member;
+        }
+        return GetBaseSettings().*Member;
+    }
+
+    // True if the bone layout comes from the profile, so its precomputed bone lengths can be shared
+    bool UsesProfileBones() const { return Profile && !HasOverride(EIKLegSetting::BoneCount) && !HasOverride(EIKLegSetting::BoneLength); }
+    // True if the step shape comes from the profile, so its precomputed step curve can be shared
+    bool UsesProfileStepCurve() const { return Profile && !HasOverride(EIKLegSetting::StepHeight) && !HasOverride(EIKLegSetting::StepEaseCurveExponent); }
+    const TArray<float>& GetSolveBoneLengths() const { return UsesProfileBones() ? Profile->GetBoneLengths() : BoneLengths; }
+
+    // Only filled for legs that don't use the profile's bone layout
+    TArray<float> BoneLengths;
+    float TotalLength = 0.0f;
+
+#if WITH_EDITORONLY_DATA
+    // Per-leg values from before the override list, only loaded so PostLoad can move them into Overrides
+    UPROPERTY()
+    uint8 bOverride_BoneCount : 1;
+    UPROPERTY()
+    uint8 bOverride_BoneLength : 1;
+    UPROPERTY()
+    uint8 bOverride_Iterations : 1;
+    UPROPERTY()
+    uint8 bOverride_Tolerance : 1;
+    UPROPERTY()
+    uint8 bOverride_StepDistance : 1;
+    UPROPERTY()
+    uint8 bOverride_StepHeight : 1;
+    UPROPERTY()
+    uint8 bOverride_StepEaseCurveExponent : 1;
+    UPROPERTY()
+    uint8 bOverride_EndEffectorMaxSpeed : 1;
+    UPROPERTY()
+    uint8 bOverride_MaxStepHeighPercentage : 1;
+    UPROPERTY()
+    int32 BoneCount = 2;
+    UPROPERTY()
+    float BoneLength = 100.0f;
+    UPROPERTY()
+    int32 Iterations = 10;
+    UPROPERTY()
+    float Tolerance = 0.01f;
+    UPROPERTY()
+    float StepDistance = 100.0f;
+    UPROPERTY()
+    float StepHeight = 25.0f;
+    UPROPERTY()
+    float StepEaseCurveExponent = 2.0f;
+    UPROPERTY()
+    float EndEffectorMaxSpeed = 0.01f;
+    UPROPERTY()
+    float MaxStepHeighPercentage = 0.5f;
+#endif
 
 };
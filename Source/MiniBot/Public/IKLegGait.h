@@ -0,0 +1,39 @@
+#pragma once
+
+#include "CoreMinimal.h"
+
+// Ground sample under one foothold candidate
+struct FIKFootholdSample
+{
+	bool bHit = false;
+	FVector Location = FVector::ZeroVector;
+	FVector Normal = FVector::UpVector;
+};
+
+// Stepping rules shared by UIKLegComponent and the tuning commandlet, so the commandlet simulates the same gait the game runs.
+// Pure functions on plain values, no UObjects and no scene queries
+class MINIBOT_API FIKLegGait
+{
+public:
+	// Step target position relative to the leg, pushed a step ahead in the (leg space) move direction
+	static FVector GetStepTargetOffset(const FVector& StartOffset, const FVector& LocalMoveDirection, float StepDistance);
+
+	// True if the foot has fallen too far behind its step target or out of reach of the root.
+	// Doesn't check whether another leg is already stepping, that's up to the caller
+	static bool ShouldStep(const FVector& EndEffectorTarget, const FVector& EndEffectorLocation, const FVector& StepTargetLocation,
+		const FVector& RootLocation, float StepDistance, float TotalLength);
+
+	// Eased horizontal alpha and sine arc height for a step at Alpha in [0, 1]
+	static void EvaluateStepCurve(float Alpha, float EaseExponent, float StepHeight, float& OutHorizontalAlpha, float& OutVerticalOffset);
+	static FVector GetStepLocation(const FVector& Start, const FVector& Target, float HorizontalAlpha, float VerticalOffset);
+
+	// Where the step target will be once the foot lands, never more than a step away
+	static FVector PredictFoothold(const FVector& StepTargetLocation, FVector Velocity, float InterpolationDuration, float StepDistance);
+
+	// The predicted point first, followed by a ring around it
+	static void MakeFootholdCandidates(const FVector& PredictedLocation, float RingRadius, int32 RingCandidates, TArray<FVector>& OutCandidates);
+
+	// Picks the best sample, Samples must line up with MakeFootholdCandidates. Returns INDEX_NONE if every sample was rejected
+	static int32 SelectFoothold(TConstArrayView<FIKFootholdSample> Samples, const FVector& PredictedLocation, const FVector& RootLocation,
+		float TotalLength, float RingRadius, float MaxSlopeAngle, float EdgeHeight);
+};
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/DataAsset.h"
+#include "IKLegProfile.generated.h"
+
+// Settings in FIKLegSettings that a leg can override
+UENUM(BlueprintType)
+enum class EIKLegSetting : uint8
+{
+	BoneCount,
+	BoneLength,
+	Iterations,
+	Tolerance,
+	StepDistance,
+	StepHeight,
+	StepEaseCurveExponent,
+	InterpolationDuration,
+	EndEffectorMaxSpeed,
+	MaxStepHeighPercentage,
+};
+
+// Tuning values shared by every leg of a type
+USTRUCT(BlueprintType)
+struct FIKLegSettings
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK", meta = (ClampMin = "1"))
+	int32 BoneCount = 2;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+	float BoneLength = 100.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+	int32 Iterations = 10;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+	float Tolerance = 0.01f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step")
+	float StepDistance = 100.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step")
+	float StepHeight = 25.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step")
+	float StepEaseCurveExponent = 2.0f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step", meta = (ClampMin = "0.01"))
+	float InterpolationDuration = 0.15f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step")
+	float EndEffectorMaxSpeed = 0.01f;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Step", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float MaxStepHeighPercentage = 0.5f;
+
+	// Generic access for per-leg overrides, integer settings are rounded
+	float GetValue(EIKLegSetting Setting) const;
+	void SetValue(EIKLegSetting Setting, float Value);
+};
+
+// A single setting a leg changes from its profile, legs only store the settings they actually override
+USTRUCT(BlueprintType)
+struct FIKLegSettingOverride
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+	EIKLegSetting Setting = EIKLegSetting::BoneCount;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "IK")
+	float Value = 0.0f;
+};
+
+class UIKLegProfile;
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnIKLegProfileChanged, const UIKLegProfile*);
+
+// Leg profile asset, legs referencing it read their settings from here unless they override them,
+// and values derived from the settings are computed once here instead of per leg
+UCLASS(BlueprintType)
+class MINIBOT_API UIKLegProfile : public UDataAsset
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Leg", meta = (ShowOnlyInnerProperties))
+	FIKLegSettings Settings;
+
+	virtual void PostInitProperties() override;
+	virtual void PostLoad() override;
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+	float GetTotalLength() const { return TotalLength; }
+
+	// Broadcast after the settings were edited and the derived data rebuilt. Legs read most settings live,
+	// but the bone layout is baked into each leg at Initialize, so legs re-initialize when this fires
+	FOnIKLegProfileChanged OnProfileChanged;
+
+	// Bone lengths laid out the way FIKChainSolver expects them, root first with zero length
+	const TArray<float>& GetBoneLengths() const { return BoneLengths; }
+
+	// Samples the precomputed step curve, returns the eased horizontal alpha and the vertical offset
+	void EvaluateStepCurve(float Alpha, float& OutHorizontalAlpha, float& OutVerticalOffset) const;
+
+	static constexpr int32 StepCurveSamples = 64;
+
+private:
+	void RebuildDerivedData();
+
+	float TotalLength = 0.0f;
+	TArray<float> BoneLengths;
+	TArray<float> StepHorizontalCurve;
+	TArray<float> StepVerticalCurve;
+};
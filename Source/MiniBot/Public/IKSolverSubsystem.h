@@ -0,0 +1,62 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "IKChainSolver.h"
+#include "Containers/TripleBuffer.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "IKSolverSubsystem.generated.h"
+
+class FIKSolveWorker;
+
+// Snapshot of a leg published by the game thread for the worker to solve, positions are relative to RootTransform
+struct FIKLegSolveInput
+{
+	FTransform RootTransform;
+	TArray<FVector3f> Positions;
+	TArray<float> BoneLengths;
+	FIKChainSolveParams3f Params;
+	FIKChainSolver3f::FSolveFunction SolveFunction = &FIKChainSolver3f::SolveGeneric;
+	uint32 Generation = 0;
+};
+
+// Solved joint positions published by the worker for the game thread to apply
+struct FIKLegSolveOutput
+{
+	FTransform RootTransform;
+	TArray<FVector3f> Positions;
+	FIKChainSolveResult Result;
+	uint32 Generation = 0; // Copied from the input, lets the leg drop results solved before a reset
+};
+
+// Per leg channel between the game thread and the IK worker. Each triple buffer has exactly one writer and one
+// reader, so neither side ever waits on the other; the reader always sees the latest complete snapshot
+class FIKLegSolvePipeline
+{
+public:
+	TTripleBuffer<FIKLegSolveInput> Input;
+	TTripleBuffer<FIKLegSolveOutput> Output;
+};
+
+typedef TSharedPtr<FIKLegSolvePipeline, ESPMode::ThreadSafe> FIKLegSolvePipelinePtr;
+
+// Owns the dedicated IK worker thread and kicks it once per frame, after all legs have published their snapshots
+UCLASS()
+class MINIBOT_API UIKSolverSubsystem : public UTickableWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UIKSolverSubsystem();
+	virtual ~UIKSolverSubsystem() override; // Out of line since FIKSolveWorker is only forward declared here
+
+	virtual void Deinitialize() override;
+	virtual void Tick(float DeltaTime) override;
+	virtual TStatId GetStatId() const override;
+
+	// Returns null if the platform can't run the worker, the leg should then solve on the game thread
+	FIKLegSolvePipelinePtr RegisterLeg();
+	void UnregisterLeg(const FIKLegSolvePipelinePtr& Pipeline);
+
+private:
+	TUniquePtr<FIKSolveWorker> Worker;
+};
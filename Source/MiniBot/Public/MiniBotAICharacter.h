@@ -0,0 +1,15 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MiniBotCharacter.h"
+#include "MiniBotAICharacter.generated.h"
+
+// MiniBot variant for AI controlled bots, skips the camera components since nobody looks through them
+UCLASS()
+class MINIBOT_API AMiniBotAICharacter : public AMiniBotCharacter
+{
+	GENERATED_BODY()
+
+public:
+	AMiniBotAICharacter(const FObjectInitializer& ObjectInitializer);
+};
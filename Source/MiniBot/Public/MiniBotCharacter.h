@@ -11,19 +11,37 @@ class MINIBOT_API AMiniBotCharacter : public ACharacter
 	GENERATED_BODY()
 
 public:
-	AMiniBotCharacter();
+	AMiniBotCharacter(const FObjectInitializer& ObjectInitializer = FObjectInitializer::Get());
+
+	// Subobject names, so subclasses can skip creating the camera with DoNotCreateDefaultSubobject
+	static FName CameraBoomName;
+	static FName FollowCameraName;
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 	virtual void Tick(float DeltaTime) override;
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+public:
+	virtual void AddMovementInput(FVector WorldDirection, float ScaleValue = 1.0f, bool bForce = false) override;
+
 private:
 	// Helper function to initialize leg components
 	void SetupLegs();
 
+	// Helper function to enable or disable ticking on the actor and all legs
+	void SetBotTickEnabled(bool bEnabled);
+
+	// Dormancy helpers
+	void UpdateDormancy(float DeltaTime, const FVector& TargetBodyLocation);
+	void EnterDormancy();
+	void StopWatchingForWake();
+	UFUNCTION()
+	void OnDormantMovementUpdated(float DeltaSeconds, FVector OldLocation, FVector OldVelocity);
+
 public:
-	// Camera and input setup
+	// Camera and input setup (the camera is optional and may be null on AI bots)
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = Camera, meta = (AllowPrivateAccess = "true"))
 	class USpringArmComponent* CameraBoom;
 	
@@ -87,5 +105,40 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Integrators", meta = (ClampMin = "-1.0", ClampMax = "1.0"))
 	float BodyResponseUnderShoot;
 
-	
+public:
+	// Dormancy, idle bots stop ticking their body and legs until something moves them
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dormancy")
+	bool bAllowDormancy = true;
+	// How long the bot has to be completely still before it goes dormant
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dormancy", meta = (ClampMin = "0.0"))
+	float DormancyDelay = 0.5f;
+	// How close the body has to be to its target, and how slow, to count as settled
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Dormancy", meta = (ClampMin = "0.0"))
+	float BodySettleTolerance = 0.1f;
+
+	UFUNCTION(BlueprintCallable, Category = "Dormancy")
+	void WakeUp();
+	UFUNCTION(BlueprintCallable, Category = "Dormancy")
+	bool IsDormant() const { return bIsDormant; }
+
+public:
+	// Pooling, see UMiniBotPoolSubsystem
+	void ActivateFromPool(const FTransform& SpawnTransform);
+	void DeactivateToPool();
+	void ResetBotState();
+
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	bool IsPooled() const { return bIsPooled; }
+
+private:
+	bool bIsDormant = false;
+	float StillTime = 0.0f;
+	FVector DormantLocation = FVector::ZeroVector;
+	TWeakObjectPtr<UPrimitiveComponent> DormantBase;
+
+	bool bIsPooled = false;
+	// AI controller kept across pool cycles, unpossessed and stopped while the bot is pooled
+	UPROPERTY()
+	TObjectPtr<AController> PooledController;
+	FVector BodyRestLocation = FVector::ZeroVector;
 };
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MiniBotPoolSubsystem.generated.h"
+
+class AMiniBotCharacter;
+
+USTRUCT()
+struct FMiniBotPool
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	TArray<TObjectPtr<AMiniBotCharacter>> FreeBots;
+};
+
+// Keeps deactivated MiniBots around so they can be reused instead of spawned and destroyed
+UCLASS()
+class MINIBOT_API UMiniBotPoolSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	virtual void Deinitialize() override;
+
+	// Spawns bots up front so later acquires don't have to construct them
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	void Prewarm(TSubclassOf<AMiniBotCharacter> BotClass, int32 Count);
+
+	// Returns a pooled bot at the given transform, spawning a new one if the pool is empty
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	AMiniBotCharacter* AcquireBot(TSubclassOf<AMiniBotCharacter> BotClass, const FTransform& SpawnTransform);
+
+	// Deactivates the bot and returns it to the pool
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	void ReleaseBot(AMiniBotCharacter* Bot);
+
+	UFUNCTION(BlueprintCallable, Category = "Pool")
+	int32 GetFreeBotCount(TSubclassOf<AMiniBotCharacter> BotClass) const;
+
+private:
+	AMiniBotCharacter* SpawnBot(UClass* BotClass, const FTransform& SpawnTransform) const;
+
+	UPROPERTY()
+	TMap<TObjectPtr<UClass>, FMiniBotPool> Pools;
+};
@@ -0,0 +1,23 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MiniBotTuningCommandlet.generated.h"
+
+// Runs headless MiniBot gait simulations over a grid of solver, step and body settings in parallel and reports
+// solver cost, iterations, steps, IK reach error and body jitter for each configuration. Solver cost is timed afterwards
+// in a single threaded replay of each configuration's solves, the rest comes from the parallel sweep.
+//
+// Usage: UnrealEditor-Cmd MiniBot.uproject -run=MiniBotTuning -BoneCount=2,3 -BoneLength=80,100 -Iterations=5,10,20
+//        -Tolerance=0.01,0.1 -StepDistance=80,100 -InterpolationDuration=0.1,0.15 -BodyFrequency=2 -BodyDamping=0.5,1
+//        -BodyUnderShoot=0 [-SimSeconds=20] [-Speed=300] [-Terrain=20] [-TimingRepeats=5] [-PredictFootholds=false] [-Output=Path.csv]
+UCLASS()
+class MINIBOT_API UMiniBotTuningCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMiniBotTuningCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -12,6 +12,12 @@ public:
 	void Initialize(const FVector& InitialPosition, float Frequency, float Damping, float UnderShoot);
 	FVector Update(float DeltaTime, const FVector& TargetPosition, FVector Velocity = FVector::ZeroVector);
 
+	// Clears the integrator history so it can be reused without reallocating
+	void Reset(const FVector& InitialPosition);
+
+	// True once the output has reached the target and stopped moving
+	bool IsSettled(const FVector& TargetPosition, float Tolerance) const;
+
 private:
 	FVector Previous;
 	FVector Current;